@@ -0,0 +1,384 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <limits.h>
+
+#ifdef _WIN32
+#include <process.h>
+#define get_process_id	_getpid
+#else
+#include <unistd.h>
+#define get_process_id	getpid
+#endif
+
+#include "SortAlgorithms.h"
+#include "TaskScheduler.h"
+#include "KWayMerge.h"
+#include "ExternalSort.h"
+
+// 鲢ʱÿζСֽԽѰԽ
+#define EXTERNAL_SORT_MERGE_BUFFER	((size_t)64 << 10)
+
+// Σʱļ
+struct External_Run {
+	char* path;
+};
+
+struct External_Sort_State {
+	const char* tempDirectory;
+	size_t memoryLimit;
+	External_Run* runs;
+	int runCount;
+	int runCapacity;
+	int nextId;			// ʱļı
+};
+
+// ̵̨߳񣺶һд
+struct External_Sort_Job {
+	int* data;
+	size_t count;
+	FILE* file;
+	bool ok;
+};
+
+// ½һΣ±꣬ʧʱ -1
+int external_run_create(External_Sort_State* state)
+{
+	if (state->runCount == state->runCapacity) {
+		int capacity = state->runCapacity ? state->runCapacity * 2 : 16;
+		External_Run* runs = (External_Run*)realloc(state->runs, capacity * sizeof(External_Run));
+		if (!runs) {
+			return -1;
+		}
+
+		state->runs = runs;
+		state->runCapacity = capacity;
+	}
+
+	External_Run* run = &state->runs[state->runCount];
+	run->path = (char*)malloc(strlen(state->tempDirectory) + 64);
+	if (!run->path) {
+		return -1;
+	}
+
+	sprintf(run->path, "%s/external_sort_%d_%d.run", state->tempDirectory,
+		(int)get_process_id(), state->nextId++);
+
+	return state->runCount++;
+}
+
+void external_run_remove(External_Run* run)
+{
+	remove(run->path);
+	free(run->path);
+}
+
+//  count  intضĸ*partial ʾļĩβһ int
+size_t read_ints(FILE* file, int* buffer, size_t count, bool* partial)
+{
+	size_t bytes = fread(buffer, 1, count * sizeof(int), file);
+
+	*partial = (bytes % sizeof(int)) != 0;
+
+	return bytes / sizeof(int);
+}
+
+bool write_ints(FILE* file, const int* buffer, size_t count)
+{
+	return fwrite(buffer, sizeof(int), count, file) == count;
+}
+
+void external_sort_job_run(void* arg)
+{
+	External_Sort_Job* job = (External_Sort_Job*)arg;
+
+	quick_sort(job->data, (int)job->count);
+
+	job->ok = write_ints(job->file, job->data, job->count);
+	if (fclose(job->file) != 0) {
+		job->ok = false;
+	}
+}
+
+// ΡһηŽڴʱֱд outputPath*done Ϊ true
+bool external_sort_make_runs(External_Sort_State* state, FILE* input,
+	const char* outputPath, bool* done)
+{
+	// 黺ʹãһں̨дһһ
+	size_t chunkCount = state->memoryLimit / 2 / sizeof(int);
+	if (chunkCount > INT_MAX) {
+		chunkCount = INT_MAX;
+	}
+
+	int* buffers[2];
+	External_Sort_Job jobs[2];
+	Thread* worker = NULL;
+	int pending = -1;		// ں̨Ļ
+	int current = 0;
+	bool ok = true;
+	bool partial = false;
+	size_t count;
+
+	*done = false;
+
+	buffers[0] = (int*)malloc(chunkCount * sizeof(int));
+	buffers[1] = (int*)malloc(chunkCount * sizeof(int));
+	if (!buffers[0] || !buffers[1]) {
+		free(buffers[0]);
+		free(buffers[1]);
+		return false;
+	}
+
+	for (;;) {
+		count = read_ints(input, buffers[current], chunkCount, &partial);
+		if (partial || ferror(input)) {
+			ok = false;
+			break;
+		}
+
+		if (count == 0) {
+			break;
+		}
+
+		// һͶļĩβļڴֱд
+		if (pending < 0 && state->runCount == 0 && count < chunkCount) {
+			FILE* output;
+
+			fclose(input);
+			input = NULL;
+
+			quick_sort(buffers[current], (int)count);
+
+			output = fopen(outputPath, "wb");
+			ok = output && write_ints(output, buffers[current], count);
+			if (output && fclose(output) != 0) {
+				ok = false;
+			}
+
+			*done = true;
+			break;
+		}
+
+		int index = external_run_create(state);
+		if (index < 0) {
+			ok = false;
+			break;
+		}
+
+		External_Sort_Job* job = &jobs[current];
+		job->data = buffers[current];
+		job->count = count;
+		job->ok = false;
+		job->file = fopen(state->runs[index].path, "wb");
+		if (!job->file) {
+			ok = false;
+			break;
+		}
+
+		// ȴһ鴦꣬ٴ
+		if (worker) {
+			thread_join(worker);
+			worker = NULL;
+		}
+
+		if (pending >= 0 && !jobs[pending].ok) {
+			fclose(job->file);
+			ok = false;
+			pending = -1;
+			break;
+		}
+
+		// ̴߳ʧʱڵǰ߳
+		worker = thread_create(external_sort_job_run, job);
+		if (!worker) {
+			external_sort_job_run(job);
+		}
+
+		pending = current;
+		current ^= 1;
+	}
+
+	if (worker) {
+		thread_join(worker);
+	}
+
+	if (pending >= 0 && !jobs[pending].ok) {
+		ok = false;
+	}
+
+	if (input) {
+		fclose(input);
+	}
+
+	free(buffers[0]);
+	free(buffers[1]);
+
+	return ok;
+}
+
+// k ·鲢һ·룺ȡһ
+struct Merge_Input {
+	FILE* file;
+	int* buffer;
+	size_t capacity;
+};
+
+// KWay_Read_Functionһ飬ļʱ *count Ϊ 0
+bool merge_input_read(void* context, const int** block, size_t* count)
+{
+	Merge_Input* input = (Merge_Input*)context;
+	bool partial;
+
+	*count = read_ints(input->file, input->buffer, input->capacity, &partial);
+	*block = input->buffer;
+
+	return !partial && !ferror(input->file);
+}
+
+//  runs[first, first + count) 鲢д output
+bool external_sort_merge(External_Sort_State* state, int first, int count, FILE* output)
+{
+	// Ϊļ
+	if (count == 0) {
+		return true;
+	}
+
+	// ڴƽָ·һ
+	size_t capacity = state->memoryLimit / (count + 1) / sizeof(int);
+	Merge_Input* inputs = (Merge_Input*)calloc(count, sizeof(Merge_Input));
+	KWay_Source* sources = (KWay_Source*)malloc(count * sizeof(KWay_Source));
+	int* out = (int*)malloc(capacity * sizeof(int));
+	KWay_Merge merge;
+	size_t outSize;
+	bool ok = (inputs && sources && out);
+	int i;
+
+	for (i = 0; ok && i < count; ++i) {
+		inputs[i].capacity = capacity;
+		inputs[i].buffer = (int*)malloc(capacity * sizeof(int));
+		inputs[i].file = fopen(state->runs[first + i].path, "rb");
+		if (!inputs[i].buffer || !inputs[i].file) {
+			ok = false;
+			break;
+		}
+
+		sources[i] = kway_source_stream(merge_input_read, &inputs[i]);
+	}
+
+	// 鲢ÿȡһĽд
+	if (ok && kway_merge_init(&merge, sources, count)) {
+		while ((outSize = kway_merge_read(&merge, out, capacity)) > 0) {
+			if (!write_ints(output, out, outSize)) {
+				ok = false;
+				break;
+			}
+		}
+
+		if (kway_merge_failed(&merge)) {
+			ok = false;
+		}
+
+		kway_merge_destroy(&merge);
+	}
+	else {
+		ok = false;
+	}
+
+	if (inputs) {
+		for (i = 0; i < count; ++i) {
+			if (inputs[i].file) {
+				fclose(inputs[i].file);
+			}
+			free(inputs[i].buffer);
+		}
+	}
+
+	free(inputs);
+	free(sources);
+	free(out);
+
+	return ok;
+}
+
+bool external_sort(const char* inputPath, const char* outputPath,
+	size_t memoryLimit, const char* tempDirectory)
+{
+	assert(inputPath && outputPath);
+
+	External_Sort_State state;
+	FILE* input;
+	FILE* output;
+	bool done = false;
+	bool ok;
+	int i, index, fanIn;
+
+	if (memoryLimit == 0) {
+		memoryLimit = EXTERNAL_SORT_DEFAULT_MEMORY;
+	}
+	if (memoryLimit < EXTERNAL_SORT_MIN_MEMORY) {
+		memoryLimit = EXTERNAL_SORT_MIN_MEMORY;
+	}
+
+	state.tempDirectory = tempDirectory ? tempDirectory : ".";
+	state.memoryLimit = memoryLimit;
+	state.runs = NULL;
+	state.runCount = 0;
+	state.runCapacity = 0;
+	state.nextId = 0;
+
+	input = fopen(inputPath, "rb");
+	if (!input) {
+		return false;
+	}
+
+	ok = external_sort_make_runs(&state, input, outputPath, &done);
+
+	// ÿ·ĻС EXTERNAL_SORT_MERGE_BUFFERɴ˾һι鲢·
+	fanIn = (int)(memoryLimit / EXTERNAL_SORT_MERGE_BUFFER) - 1;
+	if (fanIn < 2) {
+		fanIn = 2;
+	}
+
+	// ιʱȰ fanIn ι鲢һ׷ӵĩβֱһι鲢
+	int first = 0;
+	while (ok && !done && state.runCount - first > fanIn) {
+		index = external_run_create(&state);
+		output = (index >= 0) ? fopen(state.runs[index].path, "wb") : NULL;
+		if (!output) {
+			ok = false;
+			break;
+		}
+
+		ok = external_sort_merge(&state, first, fanIn, output);
+		if (fclose(output) != 0) {
+			ok = false;
+		}
+
+		for (i = first; i < first + fanIn; ++i) {
+			external_run_remove(&state.runs[i]);
+		}
+		first += fanIn;
+	}
+
+	if (ok && !done) {
+		output = fopen(outputPath, "wb");
+		if (output) {
+			ok = external_sort_merge(&state, first, state.runCount - first, output);
+			if (fclose(output) != 0) {
+				ok = false;
+			}
+		}
+		else {
+			ok = false;
+		}
+	}
+
+	for (i = first; i < state.runCount; ++i) {
+		external_run_remove(&state.runs[i]);
+	}
+
+	free(state.runs);
+
+	return ok;
+}
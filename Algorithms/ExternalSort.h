@@ -0,0 +1,35 @@
+#ifndef __EXTERNAL_SORT_H__
+#define __EXTERNAL_SORT_H__
+
+#include <stddef.h>
+
+// memoryLimit Ϊ 0 ʱʹõڴ
+#define EXTERNAL_SORT_DEFAULT_MEMORY	((size_t)256 << 20)
+
+// ڴ޵СֵСֵᱻߵֵ
+#define EXTERNAL_SORT_MIN_MEMORY		((size_t)1 << 20)
+
+/**
+* 㷨	 ⲿ鲢
+* 㷨	 ԷŲڴļļɱֽ int ɡ
+*             1) Σڴްֿ룬 quick_sort д
+*                ʱļʹ̨߳дһʱ߳
+*                ͬʱһ飬дصС
+*             2) ·鲢ÿηһĶð k ·
+*                鲢 KWayMerge.hдǴ˳ʡ̫ࡢÿεĻС
+*                EXTERNAL_SORT_MERGE_BUFFER ʱȰɶι鲢ɸĶΡ
+*             һηŽڴʱֱдʱļڴ
+*             ֽͬ
+* ʱ临Ӷ O(nlgn)д O(n * (1 + 鲢))
+* ռ临Ӷ ڴ治 memoryLimitʱļļȳ
+* ȶ	 
+* 		 inputPath  outputPath ͬһļ
+*             memoryLimit ΪõֽΪ 0 ʱʹ EXTERNAL_SORT_DEFAULT_MEMORY
+*             tempDirectory ΪʱļĿ¼Ϊ NULL ʱʹõǰĿ¼
+* ֵ	 ļ޷дȲ sizeof(int) ڴ治ʱ false
+*             ɵʱļᱻɾ
+*/
+bool external_sort(const char* inputPath, const char* outputPath,
+	size_t memoryLimit = 0, const char* tempDirectory = NULL);
+
+#endif // __EXTERNAL_SORT_H__
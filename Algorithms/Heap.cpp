@@ -0,0 +1,514 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <memory.h>
+#include <assert.h>
+
+#include "Heap.h"
+#include "SortAlgorithms.h"
+#include "SimdSort.h"
+
+// дСPriority_Queue ˶
+#define HEAP_CACHE_LINE		64
+
+// ѵ˳Order::before(a, b) ʾ a Ӧ b Ϸ
+struct Heap_Max_Order {
+	static bool before(int a, int b) { return a > b; }
+};
+
+struct Heap_Min_Order {
+	static bool before(int a, int b) { return a < b; }
+};
+
+#if defined(__GNUC__) || defined(__clang__)
+#define heap_prefetch(address)	__builtin_prefetch(address)
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#define heap_prefetch(address)	_mm_prefetch((const char*)(address), _MM_HINT_T0)
+#else
+#define heap_prefetch(address)
+#endif
+
+inline size_t heap_first_child(size_t i)
+{
+	return HEAP_ARITY * i + 1;
+}
+
+inline size_t heap_parent(size_t i)
+{
+	return (i - 1) / HEAP_ARITY;
+}
+
+// 4 ŵһȽϺٱȽһΣ3 αȽϻĲֿԲ
+template <typename Order>
+inline size_t heap_best_of_4(const int* heap, size_t first)
+{
+	size_t a = first + Order::before(heap[first + 1], heap[first]);
+	size_t b = first + 2 + Order::before(heap[first + 3], heap[first + 2]);
+
+	return Order::before(heap[b], heap[a]) ? b : a;
+}
+
+//  [first, first + count) ŵһcount < HEAP_ARITY
+template <typename Order>
+inline size_t heap_best_child(const int* heap, size_t first, size_t count)
+{
+	size_t best = first;
+
+	for (size_t k = 1; k < count; ++k) {
+		if (Order::before(heap[first + k], heap[best])) {
+			best = first + k;
+		}
+	}
+
+	return best;
+}
+
+// ϸ value ӿλ i ƶԽ top
+template <typename Order>
+inline void heap_sift_up(int* heap, size_t i, size_t top, int value)
+{
+	size_t parent;
+
+	while (i > top) {
+		parent = heap_parent(i);
+		if (!Order::before(value, heap[parent])) {
+			break;
+		}
+
+		heap[i] = heap[parent];
+		i = parent;
+	}
+
+	heap[i] = value;
+}
+
+// Floyd Եɸѡi Ϊλ i ΪಿǶѣ value 
+template <typename Order>
+void heap_sift_down(int* heap, size_t i, size_t length, int value)
+{
+	size_t top = i;
+	size_t child;
+
+	// λŵĺƵҶӣ value Ƚϡ
+	// ͬʱԤȡһ 16 㣨 64 ֽڣݳʱǰ
+	while ((child = heap_first_child(i)) + HEAP_ARITY <= length) {
+		heap_prefetch(heap + heap_first_child(child));
+		child = heap_best_of_4<Order>(heap, child);
+		heap[i] = heap[child];
+		i = child;
+	}
+
+	// һڲܲ 4 
+	if (child < length) {
+		child = heap_best_child<Order>(heap, child, length - child);
+		heap[i] = heap[child];
+		i = child;
+	}
+
+	heap_sift_up<Order>(heap, i, top, value);
+}
+
+// 򽨺 root Ϊ
+template <typename Order>
+void heap_build_subtree(int* heap, size_t root, size_t length)
+{
+	size_t first = heap_first_child(root);
+	size_t k;
+
+	if (first >= length) {
+		return;
+	}
+
+	// ӻкʱȵݹ齨úӵ
+	if (heap_first_child(first) < length) {
+		for (k = 0; k < HEAP_ARITY && first + k < length; ++k) {
+			heap_build_subtree<Order>(heap, first + k, length);
+		}
+	}
+
+	heap_sift_down<Order>(heap, root, length, heap[root]);
+}
+
+template <typename Order>
+inline void heap_pop(int* heap, size_t length)
+{
+	assert(heap && length > 0);
+
+	int value = heap[length - 1];
+
+	heap[length - 1] = heap[0];
+
+	if (length > 1) {
+		heap_sift_down<Order>(heap, 0, length - 1, value);
+	}
+}
+
+void max_heap_build(int* heap, size_t length)
+{
+	assert(heap || length == 0);
+
+	heap_build_subtree<Heap_Max_Order>(heap, 0, length);
+}
+
+void max_heap_pop(int* heap, size_t length)
+{
+	heap_pop<Heap_Max_Order>(heap, length);
+}
+
+void min_heap_build(int* heap, size_t length)
+{
+	assert(heap || length == 0);
+
+	heap_build_subtree<Heap_Min_Order>(heap, 0, length);
+}
+
+void min_heap_push(int* heap, size_t length)
+{
+	assert(heap && length > 0);
+
+	heap_sift_up<Heap_Min_Order>(heap, length - 1, 0, heap[length - 1]);
+}
+
+void min_heap_pop(int* heap, size_t length)
+{
+	heap_pop<Heap_Min_Order>(heap, length);
+}
+
+void min_heap_replace_top(int* heap, size_t length, int value)
+{
+	assert(heap && length > 0);
+
+	heap_sift_down<Heap_Min_Order>(heap, 0, length, value);
+}
+
+
+//=========================================================
+//					ȶ
+//=========================================================
+
+//  capacity ¼飬ʹ heap[1]һ麢ӣ뵽
+bool priority_queue_allocate(Priority_Queue* queue, size_t capacity)
+{
+	void* memory = malloc((capacity + 1) * sizeof(int) + HEAP_CACHE_LINE);
+	if (!memory) {
+		return false;
+	}
+
+	size_t address = (size_t)memory + sizeof(int) + HEAP_CACHE_LINE - 1;
+	int* heap = (int*)(address - address % HEAP_CACHE_LINE) - 1;
+
+	if (queue->count > 0) {
+		memcpy(heap, queue->heap, queue->count * sizeof(int));
+	}
+
+	free(queue->memory);
+	queue->memory = memory;
+	queue->heap = heap;
+	queue->capacity = capacity;
+
+	return true;
+}
+
+bool priority_queue_reserve(Priority_Queue* queue, size_t count)
+{
+	size_t capacity = queue->capacity;
+
+	if (count <= capacity) {
+		return true;
+	}
+
+	while (capacity < count) {
+		capacity = capacity ? capacity * 2 : 16;
+	}
+
+	return priority_queue_allocate(queue, capacity);
+}
+
+bool priority_queue_init(Priority_Queue* queue, size_t capacity)
+{
+	assert(queue);
+
+	queue->heap = NULL;
+	queue->memory = NULL;
+	queue->count = 0;
+	queue->capacity = 0;
+
+	return priority_queue_allocate(queue, capacity > 0 ? capacity : 16);
+}
+
+void priority_queue_destroy(Priority_Queue* queue)
+{
+	assert(queue);
+
+	free(queue->memory);
+	queue->heap = NULL;
+	queue->memory = NULL;
+	queue->count = 0;
+	queue->capacity = 0;
+}
+
+bool priority_queue_push(Priority_Queue* queue, int value)
+{
+	assert(queue);
+
+	if (!priority_queue_reserve(queue, queue->count + 1)) {
+		return false;
+	}
+
+	heap_sift_up<Heap_Min_Order>(queue->heap, queue->count++, 0, value);
+
+	return true;
+}
+
+bool priority_queue_push_all(Priority_Queue* queue, const int* values, size_t count)
+{
+	assert(queue && (values || count == 0));
+
+	if (count == 0) {
+		return true;
+	}
+
+	if (!priority_queue_reserve(queue, queue->count + count)) {
+		return false;
+	}
+
+	memcpy(queue->heap + queue->count, values, count * sizeof(int));
+
+	// ¼¼еʱϸ½
+	if (count < queue->count) {
+		while (count-- > 0) {
+			min_heap_push(queue->heap, ++queue->count);
+		}
+	}
+	else {
+		queue->count += count;
+		min_heap_build(queue->heap, queue->count);
+	}
+
+	return true;
+}
+
+int priority_queue_top(const Priority_Queue* queue)
+{
+	assert(queue && queue->count > 0);
+
+	return queue->heap[0];
+}
+
+int priority_queue_pop(Priority_Queue* queue)
+{
+	assert(queue && queue->count > 0);
+
+	min_heap_pop(queue->heap, queue->count);
+
+	return queue->heap[--queue->count];
+}
+
+int priority_queue_replace_top(Priority_Queue* queue, int value)
+{
+	assert(queue && queue->count > 0);
+
+	int top = queue->heap[0];
+
+	min_heap_replace_top(queue->heap, queue->count, value);
+
+	return top;
+}
+
+
+//=========================================================
+//					k 
+//=========================================================
+
+bool ksorted_stream_init(KSorted_Stream* stream, size_t k)
+{
+	assert(stream);
+
+	stream->chunk = NULL;
+	stream->chunkLength = (k > KSORTED_CHUNK) ? k : KSORTED_CHUNK;
+	stream->k = k;
+	stream->late = 0;
+	stream->last = 0;
+	stream->started = false;
+	stream->queueSorted = true;
+
+	return priority_queue_init(&stream->queue, k);
+}
+
+void ksorted_stream_destroy(KSorted_Stream* stream)
+{
+	assert(stream);
+
+	priority_queue_destroy(&stream->queue);
+	free(stream->chunk);
+	stream->chunk = NULL;
+}
+
+inline int ksorted_stream_emit(KSorted_Stream* stream, int value)
+{
+	if (stream->started && value < stream->last) {
+		++stream->late;
+	}
+
+	stream->last = value;
+	stream->started = true;
+
+	return value;
+}
+
+bool ksorted_stream_push(KSorted_Stream* stream, int value, int* out)
+{
+	assert(stream && out);
+
+	Priority_Queue* queue = &stream->queue;
+
+	//  init ѷΪ kʧܡСһ¼ʱĩβȻ
+	if (queue->count < stream->k) {
+		stream->queueSorted = stream->queueSorted
+			&& (queue->count == 0 || value >= queue->heap[queue->count - 1]);
+		heap_sift_up<Heap_Min_Order>(queue->heap, queue->count++, 0, value);
+		return false;
+	}
+
+	// ¼¼ȴ k ¼Сһ
+	if (queue->count == 0 || value <= queue->heap[0]) {
+		*out = ksorted_stream_emit(stream, value);
+	}
+	else {
+		*out = ksorted_stream_emit(stream, priority_queue_replace_top(queue, value));
+		stream->queueSorted = (queue->count == 1);
+	}
+
+	return true;
+}
+
+//  values[0, count)count һ顣ĸ
+size_t ksorted_stream_push_chunk(KSorted_Stream* stream, const int* values, size_t count, int* out)
+{
+	Priority_Queue* queue = &stream->queue;
+	int* chunk = stream->chunk;
+	int* merged = chunk + stream->chunkLength;
+	size_t total = queue->count + count;
+	size_t emitted = (total > stream->k) ? total - stream->k : 0;
+	size_t i;
+
+	// ȸout  values ص
+	memcpy(chunk, values, count * sizeof(int));
+	quick_sort(chunk, (int)count);
+
+	if (!stream->queueSorted) {
+		quick_sort(queue->heap, (int)queue->count);
+	}
+
+	simd_merge(queue->heap, queue->count, chunk, count, merged);
+
+	// ģļ¼ڿͷ
+	if (emitted > 0) {
+		for (i = 0; i < emitted && stream->started && merged[i] < stream->last; ++i) {
+			++stream->late;
+		}
+
+		memcpy(out, merged, emitted * sizeof(int));
+		stream->last = merged[emitted - 1];
+		stream->started = true;
+	}
+
+	queue->count = total - emitted;
+	memcpy(queue->heap, merged + emitted, queue->count * sizeof(int));
+	stream->queueSorted = true;
+
+	return emitted;
+}
+
+size_t ksorted_stream_push_all(KSorted_Stream* stream, const int* values, size_t count, int* out)
+{
+	assert(stream && ((values && out) || count == 0));
+
+	size_t n = 0;
+	size_t i = 0;
+	size_t length;
+
+	// һʱ鴦һõʱŷ䣬ʧʱ
+	if (count >= stream->k && count >= KSORTED_BATCH_MIN && !stream->chunk) {
+		stream->chunk = (int*)malloc((2 * stream->chunkLength + stream->k) * sizeof(int));
+	}
+
+	if (count >= stream->k && count >= KSORTED_BATCH_MIN && stream->chunk) {
+		for (; i < count; i += length) {
+			length = (count - i < stream->chunkLength) ? count - i : stream->chunkLength;
+			n += ksorted_stream_push_chunk(stream, values + i, length, out + n);
+		}
+	}
+
+	for (; i < count; ++i) {
+		n += ksorted_stream_push(stream, values[i], out + n);
+	}
+
+	return n;
+}
+
+bool ksorted_stream_pull(KSorted_Stream* stream, int* out)
+{
+	assert(stream && out);
+
+	if (priority_queue_empty(&stream->queue)) {
+		return false;
+	}
+
+	*out = ksorted_stream_emit(stream, priority_queue_pop(&stream->queue));
+	stream->queueSorted = (stream->queue.count == 0);
+
+	return true;
+}
+
+bool ksorted_sort(int* array, size_t length, size_t k)
+{
+	assert(array || length == 0);
+
+	KSorted_Stream stream;
+	size_t n, i;
+
+	if (length < 2) {
+		return true;
+	}
+
+	if (k >= length) {
+		k = length - 1;
+	}
+
+	if (!ksorted_stream_init(&stream, k)) {
+		return false;
+	}
+
+	// дλ n ܲλ i
+	n = ksorted_stream_push_all(&stream, array, length, array);
+
+	// 鴦ʣµ k ¼Ѿ
+	if (stream.queueSorted && stream.queue.count > 0) {
+		if (stream.started && stream.queue.heap[0] < stream.last) {
+			++stream.late;
+		}
+
+		memcpy(array + n, stream.queue.heap, stream.queue.count * sizeof(int));
+		n += stream.queue.count;
+		stream.queue.count = 0;
+	}
+
+	while (ksorted_stream_pull(&stream, array + n)) {
+		++n;
+	}
+
+	assert(n == length);
+
+	// Υλƽ磺ö
+	if (stream.late > 0) {
+		max_heap_build(array, length);
+		for (i = length; i > 1; --i) {
+			max_heap_pop(array, i);
+		}
+	}
+
+	ksorted_stream_destroy(&stream);
+
+	return true;
+}
@@ -0,0 +1,147 @@
+#ifndef __HEAP_H__
+#define __HEAP_H__
+
+#include <stddef.h>
+
+/**
+* d ѣd = HEAP_ARITY = 4
+*
+*  i ĺΪ [4i + 1, 4i + 4]˫Ϊ (i - 1) / 4ѣ
+* ߶ȼ룬4 ڵ 16 ֽڣλͬһУPriority_Queue
+* 鱣֤룩ݳÿֻһλȱʧ
+*
+* ɾѶ Floyd ԵɸѡλؽŵĺһֱƵҶӣֻ
+* ֮Ƚϣٰԭһ¼ҶӴϸ¼ͨС
+* ϸһͣ£ȽϴԼΪȽϵһ롣
+*
+* ѰУȽøӵɸѡÿĽ
+* һΣһ÷ŵýʱᷴڴ롣
+*
+* Լ C++ ׼ͬmax_heap_* Ϊ󶥶ѣmin_heap_* ΪСѡ
+*/
+#define HEAP_ARITY		4
+
+//  heap[0, length) ɴ󶥶
+void max_heap_build(int* heap, size_t length);
+
+//  heap[0] Ƶ heap[length - 1][0, length - 1) µΪ󶥶
+void max_heap_pop(int* heap, size_t length);
+
+//  heap[0, length) С
+void min_heap_build(int* heap, size_t length);
+
+// [0, length - 1) Сѣ¼ heap[length - 1] ϸʵλ
+void min_heap_push(int* heap, size_t length);
+
+//  heap[0] Ƶ heap[length - 1][0, length - 1) µΪС
+void min_heap_pop(int* heap, size_t length);
+
+//  value 滻Ѷµ൱ pop  pushֻɸѡһ
+void min_heap_replace_top(int* heap, size_t length, int value);
+
+
+/**
+* ȶУСѣѶΪСļ¼ʱԶӱ
+* 鰴ж룬ʹÿ麢Ӷ绺С
+*/
+struct Priority_Queue {
+	int* heap;
+	void* memory;		// malloc صָ룬heap ж
+	size_t count;
+	size_t capacity;
+};
+
+// ʼΪ capacity ĶУʧʱ false
+bool priority_queue_init(Priority_Queue* queue, size_t capacity);
+
+void priority_queue_destroy(Priority_Queue* queue);
+
+// ڴ治ʱ falseбֲ
+bool priority_queue_push(Priority_Queue* queue, int value);
+
+// һμ count ¼¼¼м¼ʱ½ѣ push 
+bool priority_queue_push_all(Priority_Queue* queue, const int* values, size_t count);
+
+// вΪ
+int priority_queue_top(const Priority_Queue* queue);
+
+int priority_queue_pop(Priority_Queue* queue);
+
+// Ѷ valueԭĶѶ
+int priority_queue_replace_top(Priority_Queue* queue, int value);
+
+inline size_t priority_queue_size(const Priority_Queue* queue)
+{
+	return queue->count;
+}
+
+inline bool priority_queue_empty(const Priority_Queue* queue)
+{
+	return queue->count == 0;
+}
+
+
+/**
+* k ÿ¼λ kɼ˵¼
+*  k  t ¼С t - k һȫ¼С
+*  t - k ֻ豣 k ļ¼Ķ
+* 1) ʱСѱ k ¼¼¼ڶѶʱֱ
+*    Ѷ¼¼滻ѶֻɸѡһΣ
+* 2) һμ벻 k Ҳ KSORTED_BATCH_MIN ¼ʱ鴦
+*    ¼¼뱣 k ¼鲢 k Ĳ֡
+*    鲢˳ʣÿ¼ɸѡһζѿ졣
+*    鲢ĺ k ģҲСѣַʽԻá
+* ʱ临Ӷ O(nlgk)ռ临Ӷ O(k)Ҫռȫ롣
+*
+* Υλƽʱм¼late ¼ʱС
+* ǰһļ¼ k ̫С
+*/
+#define KSORTED_BATCH_MIN		64
+
+// 鴦ʱÿٵļ¼
+#define KSORTED_CHUNK			4096
+
+struct KSorted_Stream {
+	Priority_Queue queue;	//  k δļ¼
+	int* chunk;				// 鴦ʱĻһ¼¼Լ queue Ĺ鲢
+	size_t chunkLength;		// һļ¼Ϊ max(k, KSORTED_CHUNK)
+	size_t k;
+	size_t late;			// Υλƽ硢ʱѾ˵ļ¼
+	int last;				// һļ¼
+	bool started;			// ǷѾ¼
+	bool queueSorted;		// queue еļ¼Ƿ򣨰鴦
+};
+
+// λƽΪ k ʧʱ false
+bool ksorted_stream_init(KSorted_Stream* stream, size_t k);
+
+void ksorted_stream_destroy(KSorted_Stream* stream);
+
+// һ¼ k ¼ڵȴʱһ *out  true򷵻 false
+bool ksorted_stream_push(KSorted_Stream* stream, int value, int* out);
+
+// μ values[0, count) outĸout Ҫ count 
+// out  values ͬдλڶλ֮ǰ
+size_t ksorted_stream_push_all(KSorted_Stream* stream, const int* values, size_t count, int* out);
+
+// ˳ȡʣļ¼ûʣʱ false
+bool ksorted_stream_pull(KSorted_Stream* stream, int* out);
+
+inline size_t ksorted_stream_pending(const KSorted_Stream* stream)
+{
+	return stream->queue.count;
+}
+
+/**
+* 㷨	 k 
+* 㷨	  KSorted_Stream ͵ÿ¼ƫ k λõ array
+*             һΰ룬ֱд array
+* ʱ临Ӷ O(nlgk)
+* ռ临Ӷ O(k)
+* ȶ	 
+* ֵ	 ڴ治ʱ falseʱ array ֲ䣻
+*             array Υλƽʱö򣬽Ȼ򣬺ʱΪ O(nlgn)
+*/
+bool ksorted_sort(int* array, size_t length, size_t k);
+
+#endif // __HEAP_H__
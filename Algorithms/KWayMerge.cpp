@@ -0,0 +1,201 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <memory.h>
+#include <assert.h>
+#include <limits.h>
+
+#include "SimdSort.h"
+#include "KWayMerge.h"
+
+// һ·еֵκ (¼, ·) 
+#define KWAY_SENTINEL		ULLONG_MAX
+
+// (¼, ·) Ϊ 64 λ¼ķλȡ޷ȽϼΪзŵĴС
+inline unsigned long long kway_encode(int key, int source)
+{
+	return ((unsigned long long)((unsigned int)key ^ 0x80000000u) << 32) | (unsigned int)source;
+}
+
+inline int kway_decode_key(unsigned long long value)
+{
+	return (int)((unsigned int)(value >> 32) ^ 0x80000000u);
+}
+
+inline int kway_decode_source(unsigned long long value)
+{
+	return (int)(value & 0xFFFFFFFFu);
+}
+
+// һ·һ飬ʱ cursor == end
+bool kway_source_fetch(KWay_Source* source)
+{
+	const int* block;
+	size_t count = 0;
+
+	source->cursor = source->end;
+
+	if (!source->read) {
+		return true;
+	}
+
+	if (!source->read(source->context, &block, &count)) {
+		return false;
+	}
+
+	if (count > 0) {
+		source->cursor = block;
+		source->end = block + count;
+	}
+
+	return true;
+}
+
+//  s ·ǰļ¼ʱΪڱ
+inline unsigned long long kway_source_head(const KWay_Source* source, int s)
+{
+	return (source->cursor < source->end) ? kway_encode(*source->cursor, s) : KWAY_SENTINEL;
+}
+
+bool kway_merge_init(KWay_Merge* merge, const KWay_Source* sources, int count)
+{
+	assert(merge && (sources || count == 0) && count >= 0);
+
+	unsigned long long* winners;
+	unsigned long long left, right;
+	int s, node;
+
+	merge->count = count;
+	merge->failed = false;
+	merge->tree = (unsigned long long*)malloc((count > 0 ? count : 1) * sizeof(unsigned long long));
+	merge->sources = (KWay_Source*)malloc((count > 0 ? count : 1) * sizeof(KWay_Source));
+
+	// ʱʤߣҶΪ [count, 2 * count)ڲΪ [1, count)
+	winners = (unsigned long long*)malloc(2 * (count > 0 ? count : 1) * sizeof(unsigned long long));
+
+	if (!merge->tree || !merge->sources || !winners) {
+		free(merge->tree);
+		free(merge->sources);
+		free(winners);
+		return false;
+	}
+
+	for (s = 0; s < count; ++s) {
+		merge->sources[s] = sources[s];
+		if (sources[s].read && !kway_source_fetch(&merge->sources[s])) {
+			free(merge->tree);
+			free(merge->sources);
+			free(winners);
+			return false;
+		}
+
+		winners[count + s] = kway_source_head(&merge->sources[s], s);
+	}
+
+	for (node = count - 1; node > 0; --node) {
+		left = winners[2 * node];
+		right = winners[2 * node + 1];
+		winners[node] = (left < right) ? left : right;
+		merge->tree[node] = (left < right) ? right : left;
+	}
+
+	merge->tree[0] = (count > 0) ? winners[1] : KWAY_SENTINEL;
+	free(winners);
+
+	return true;
+}
+
+void kway_merge_destroy(KWay_Merge* merge)
+{
+	assert(merge);
+
+	free(merge->tree);
+	free(merge->sources);
+	merge->tree = NULL;
+	merge->sources = NULL;
+	merge->count = 0;
+}
+
+size_t kway_merge_read(KWay_Merge* merge, int* out, size_t capacity)
+{
+	assert(merge && (out || capacity == 0));
+
+	unsigned long long* tree = merge->tree;
+	KWay_Source* sources = merge->sources;
+	KWay_Source* source;
+	unsigned long long winner, loser;
+	size_t n = 0;
+	int count = merge->count;
+	int s, node;
+
+	if (merge->failed) {
+		return 0;
+	}
+
+	while (n < capacity && (winner = tree[0]) != KWAY_SENTINEL) {
+		s = kway_decode_source(winner);
+		out[n++] = kway_decode_key(winner);
+
+		// ʤڵһ·ȡһ¼ǰʱһ
+		source = &sources[s];
+		if (++source->cursor >= source->end && !kway_source_fetch(source)) {
+			merge->failed = true;
+			break;
+		}
+		winner = kway_source_head(source, s);
+
+		// Ҷ count + s ·İ߱Ƚϣϴ¡
+		// ֻ֧Ǹֵ
+		for (node = (count + s) >> 1; node > 0; node >>= 1) {
+			loser = tree[node];
+			tree[node] = (loser < winner) ? winner : loser;
+			winner = (loser < winner) ? loser : winner;
+		}
+
+		tree[0] = winner;
+	}
+
+	return n;
+}
+
+bool kway_merge(const int* const* runs, const size_t* lengths, int count, int* out)
+{
+	assert((runs && lengths) || count == 0);
+
+	KWay_Source* sources;
+	KWay_Merge merge;
+	size_t total = 0;
+	int i;
+
+	// һ·ֱӸƣ·Ķ·鲢
+	if (count == 1) {
+		memcpy(out, runs[0], lengths[0] * sizeof(int));
+		return true;
+	}
+
+	if (count == 2) {
+		simd_merge(runs[0], lengths[0], runs[1], lengths[1], out);
+		return true;
+	}
+
+	sources = (KWay_Source*)malloc((count > 0 ? count : 1) * sizeof(KWay_Source));
+	if (!sources) {
+		return false;
+	}
+
+	for (i = 0; i < count; ++i) {
+		sources[i] = kway_source_span(runs[i], lengths[i]);
+		total += lengths[i];
+	}
+
+	if (!kway_merge_init(&merge, sources, count)) {
+		free(sources);
+		return false;
+	}
+
+	kway_merge_read(&merge, out, total);
+
+	kway_merge_destroy(&merge);
+	free(sources);
+
+	return true;
+}
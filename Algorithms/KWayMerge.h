@@ -0,0 +1,86 @@
+#ifndef __KWAY_MERGE_H__
+#define __KWAY_MERGE_H__
+
+#include <stddef.h>
+
+/**
+* k ·鲢
+*
+* ÿڲ¼ڸôʧܵһtree[0] Ϊյʤߡ
+* ʤڵһ·ȡһ¼ֻҶӵ·İ
+* Ƚϣÿһ¼Ƚ lgk ΣѵɸѡÿҪȽΡ
+*
+* дŵĲ± (¼, ·) ɵ 64 λ 32 λΪ
+* ¼תΪ޷ţ 32 λΪ·šһȽϾ͵óʤȵļ¼
+* ·žʤ˹鲢ȶģһ·ȫ 1 Ϊڱκ
+* ¼󣬲Ҫжϡ
+*
+* ڴе飬Ҳǰȡɵ߰
+* ȡkway_merge_readҪһȫֱӽδ
+*/
+
+// ȡһ·һ飺ɹʱ *block ָһ¼*count Ϊ¼
+// *count Ϊ 0 ʾ·Ѷꣻȡʱ false
+// *block һεǰ뱣Ч
+typedef bool (*KWay_Read_Function)(void* context, const int** block, size_t* count);
+
+// һ·
+struct KWay_Source {
+	const int* cursor;			// ǰһ¼
+	const int* end;				// ǰĩβ
+	KWay_Read_Function read;	// Ϊ NULL ʱֻ [cursor, end) һ
+	void* context;				// read Ĳ
+};
+
+// 鲢״̬
+struct KWay_Merge {
+	unsigned long long* tree;	// tree[0] Ϊʤߣtree[1, count) Ϊڲİ
+	KWay_Source* sources;
+	int count;					// ·
+	bool failed;				// ĳһ·ȡ
+};
+
+// ڴеһ·
+inline KWay_Source kway_source_span(const int* data, size_t length)
+{
+	KWay_Source source = {data, data + length, NULL, NULL};
+	return source;
+}
+
+// ȡһ·룬һ kway_merge_init жȡ
+inline KWay_Source kway_source_stream(KWay_Read_Function read, void* context)
+{
+	KWay_Source source = {NULL, NULL, read, context};
+	return source;
+}
+
+//  sources[0, count) ڴ治ȡһʱ false
+// ʱҪ kway_merge_destroy
+bool kway_merge_init(KWay_Merge* merge, const KWay_Source* sources, int count);
+
+void kway_merge_destroy(KWay_Merge* merge);
+
+// ȡ capacity 鲢 outдĸ
+//  0 ʾ鲢ĳһ·ȡ kway_merge_failed 
+size_t kway_merge_read(KWay_Merge* merge, int* out, size_t capacity);
+
+inline bool kway_merge_failed(const KWay_Merge* merge)
+{
+	return merge->failed;
+}
+
+/**
+* 㷨	 k ·鲢
+* 㷨	  count  runs[i][0, lengths[i]) 鲢 outֻһˡ
+*             ·ʱֱӵ simd_mergeݶڻС
+*             ȳĻʱ simd_merge 鲢 lgk ˷죻
+*             ڲҪʽԼļʱ
+*             ֻдһ
+* ʱ临Ӷ O(nlgk)n Ϊ¼
+* ռ临Ӷ O(k)
+* ȶ	 ǣȵļ¼˳
+* ֵ	 ڴ治ʱ false
+*/
+bool kway_merge(const int* const* runs, const size_t* lengths, int count, int* out);
+
+#endif // __KWAY_MERGE_H__
@@ -0,0 +1,802 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <memory.h>
+#include <assert.h>
+#include <limits.h>
+
+#include "KeyValueSort.h"
+
+//=========================================================
+//					
+//=========================================================
+
+#define PAIRS_RADIX_BITS		8
+#define PAIRS_RADIX_BUCKETS		(1 << PAIRS_RADIX_BITS)
+#define PAIRS_RADIX_MASK		(PAIRS_RADIX_BUCKETS - 1)
+
+//  radix_sort_bits ͬ LSD 򣬷ؼʱͬһѭᶯء
+// Key Ϊ޷ key ^ Flip ĴСint ؼַתλǰ棩
+// صԭĹؼ֡м¼ֽͬڲ䡣
+// Flip ΪģǱڳΪʱʵ 20%~40%
+template <typename Key, Key Flip, typename Value>
+void radix_sort_pairs_impl(Key* keys, Value* values, Key* tempKeys,
+	Value* tempValues, size_t length)
+{
+	const int passes = sizeof(Key) * 8 / PAIRS_RADIX_BITS;
+
+	size_t counts[sizeof(Key) * 8 / PAIRS_RADIX_BITS][PAIRS_RADIX_BUCKETS];
+	size_t sum, count, pos;
+	size_t i;
+	int p, d, shift;
+	Key key;
+	Key* srcKeys = keys;
+	Key* dstKeys = tempKeys;
+	Value* srcValues = values;
+	Value* dstValues = tempValues;
+	Key* swapKeys;
+	Value* swapValues;
+
+	memset(counts, 0, sizeof(counts));
+
+	for (i = 0; i < length; ++i) {
+		key = srcKeys[i] ^ Flip;
+
+		for (p = 0; p < passes; ++p) {
+			++counts[p][(key >> (p * PAIRS_RADIX_BITS)) & PAIRS_RADIX_MASK];
+		}
+	}
+
+	key = srcKeys[0] ^ Flip;
+
+	for (p = 0; p < passes; ++p) {
+		shift = p * PAIRS_RADIX_BITS;
+
+		// йؼһλ϶ͬ
+		if (counts[p][(key >> shift) & PAIRS_RADIX_MASK] == length) {
+			continue;
+		}
+
+		for (sum = 0, d = 0; d < PAIRS_RADIX_BUCKETS; ++d) {
+			count = counts[p][d];
+			counts[p][d] = sum;
+			sum += count;
+		}
+
+		for (i = 0; i < length; ++i) {
+			pos = counts[p][((srcKeys[i] ^ Flip) >> shift) & PAIRS_RADIX_MASK]++;
+			dstKeys[pos] = srcKeys[i];
+			dstValues[pos] = srcValues[i];
+		}
+
+		swapKeys = srcKeys;
+		srcKeys = dstKeys;
+		dstKeys = swapKeys;
+
+		swapValues = srcValues;
+		srcValues = dstValues;
+		dstValues = swapValues;
+	}
+
+	// ִˣڸ
+	if (srcValues != values) {
+		memcpy(keys, srcKeys, length * sizeof(Key));
+		memcpy(values, srcValues, length * sizeof(Value));
+	}
+}
+
+template <typename Value>
+bool radix_sort_pairs_alloc(int* keys, Value* values, int length)
+{
+	assert(keys && values && length >= 0);
+
+	if (length <= 1) {
+		return true;
+	}
+
+	unsigned int* tempKeys = (unsigned int*)malloc(length * sizeof(int));
+	Value* tempValues = (Value*)malloc(length * sizeof(Value));
+
+	if (!tempKeys || !tempValues) {
+		free(tempKeys);
+		free(tempValues);
+		return false;
+	}
+
+	radix_sort_pairs_impl<unsigned int, 0x80000000u>((unsigned int*)keys, values, tempKeys,
+		tempValues, length);
+
+	free(tempKeys);
+	free(tempValues);
+
+	return true;
+}
+
+bool radix_sort_pairs(int* keys, unsigned int* values, int length)
+{
+	return radix_sort_pairs_alloc(keys, values, length);
+}
+
+bool radix_sort_pairs(int* keys, unsigned long long* values, int length)
+{
+	return radix_sort_pairs_alloc(keys, values, length);
+}
+
+
+//=========================================================
+//					鲢
+//=========================================================
+
+// ʼεĳ
+#define PAIRS_MERGE_RUN		16
+
+// ֱӲ [low, high)ȵĹؼֲƶȶ
+template <typename Value>
+void insert_sort_pairs(int* keys, Value* values, int low, int high)
+{
+	int i, j, key;
+	Value value;
+
+	for (i = low + 1; i < high; ++i) {
+		key = keys[i];
+		value = values[i];
+
+		for (j = i; j > low && keys[j - 1] > key; --j) {
+			keys[j] = keys[j - 1];
+			values[j] = values[j - 1];
+		}
+
+		keys[j] = key;
+		values[j] = value;
+	}
+}
+
+//  [low, mid)  [mid, high) ι鲢 dst  [low, high)
+// ʱȡǰһεļ¼ȶ
+template <typename Value>
+void merge_pairs(const int* srcKeys, const Value* srcValues, int* dstKeys, Value* dstValues,
+	int low, int mid, int high)
+{
+	int i = low;
+	int j = mid;
+	int index = low;
+
+	while (i < mid && j < high) {
+		if (srcKeys[i] <= srcKeys[j]) {
+			dstKeys[index] = srcKeys[i];
+			dstValues[index++] = srcValues[i++];
+		}
+		else {
+			dstKeys[index] = srcKeys[j];
+			dstValues[index++] = srcValues[j++];
+		}
+	}
+
+	memcpy(dstKeys + index, srcKeys + i, (mid - i) * sizeof(int));
+	memcpy(dstValues + index, srcValues + i, (mid - i) * sizeof(Value));
+	index += mid - i;
+
+	memcpy(dstKeys + index, srcKeys + j, (high - j) * sizeof(int));
+	memcpy(dstValues + index, srcValues + j, (high - j) * sizeof(Value));
+}
+
+//  merge_sort ͬ븨֮佻鲢
+// ѡȡʼεĳʹ鲢Ϊżһǡûصԭ
+template <typename Value>
+bool merge_sort_pairs_alloc(int* keys, Value* values, int length)
+{
+	assert(keys && values && length >= 0);
+
+	int run = PAIRS_MERGE_RUN;
+	int i, n, passes;
+
+	if (length <= run) {
+		insert_sort_pairs(keys, values, 0, length);
+		return true;
+	}
+
+	int* tempKeys = (int*)malloc(length * sizeof(int));
+	Value* tempValues = (Value*)malloc(length * sizeof(Value));
+
+	if (!tempKeys || !tempValues) {
+		free(tempKeys);
+		free(tempValues);
+		return false;
+	}
+
+	int* srcKeys = keys;
+	int* dstKeys = tempKeys;
+	Value* srcValues = values;
+	Value* dstValues = tempValues;
+	int* swapKeys;
+	Value* swapValues;
+
+	for (passes = 0, n = run; n < length; n <<= 1) {
+		++passes;
+	}
+
+	if (passes & 1) {
+		run >>= 1;
+	}
+
+	for (i = 0; i < length; i += run) {
+		insert_sort_pairs(keys, values, i, (length - i < run) ? length : i + run);
+	}
+
+	for (n = run; n < length; n <<= 1) {
+		for (i = 0; i < length; i += 2 * n) {
+			if (i + n < length) {
+				merge_pairs(srcKeys, srcValues, dstKeys, dstValues,
+					i, i + n, (length - i < 2 * n) ? length : i + 2 * n);
+			}
+			else {
+				memcpy(dstKeys + i, srcKeys + i, (length - i) * sizeof(int));
+				memcpy(dstValues + i, srcValues + i, (length - i) * sizeof(Value));
+			}
+		}
+
+		swapKeys = srcKeys;
+		srcKeys = dstKeys;
+		dstKeys = swapKeys;
+
+		swapValues = srcValues;
+		srcValues = dstValues;
+		dstValues = swapValues;
+	}
+
+	assert(srcKeys == keys);
+
+	free(tempKeys);
+	free(tempValues);
+
+	return true;
+}
+
+bool merge_sort_pairs(int* keys, unsigned int* values, int length)
+{
+	return merge_sort_pairs_alloc(keys, values, length);
+}
+
+bool merge_sort_pairs(int* keys, unsigned long long* values, int length)
+{
+	return merge_sort_pairs_alloc(keys, values, length);
+}
+
+
+//=========================================================
+//					
+//=========================================================
+
+#define PAIRS_QUICK_CUTOFF			32
+#define PAIRS_NINTHER_THRESHOLD		128
+#define PAIRS_PARTITION_BLOCK_SIZE	64
+
+template <typename Value>
+inline void swap_pair(int* keys, Value* values, int a, int b)
+{
+	int key = keys[a];
+	keys[a] = keys[b];
+	keys[b] = key;
+
+	Value value = values[a];
+	values[a] = values[b];
+	values[b] = value;
+}
+
+template <typename Value>
+inline void sort3_pairs(int* keys, Value* values, int a, int b, int c)
+{
+	if (keys[b] < keys[a]) {
+		swap_pair(keys, values, a, b);
+	}
+
+	if (keys[c] < keys[b]) {
+		swap_pair(keys, values, b, c);
+
+		if (keys[b] < keys[a]) {
+			swap_pair(keys, values, a, b);
+		}
+	}
+}
+
+// ȡ/ȡУ׼ŵ [low]
+template <typename Value>
+void choose_pivot_pairs(int* keys, Value* values, int low, int high)
+{
+	int length = high - low + 1;
+	int mid = low + (length >> 1);
+
+	if (length >= PAIRS_NINTHER_THRESHOLD) {
+		int step = length >> 3;
+
+		sort3_pairs(keys, values, low, low + step, low + 2 * step);
+		sort3_pairs(keys, values, mid - step, mid, mid + step);
+		sort3_pairs(keys, values, high - 2 * step, high - step, high);
+		sort3_pairs(keys, values, low + step, mid, high - step);
+	}
+	else {
+		sort3_pairs(keys, values, low, mid, high);
+	}
+
+	swap_pair(keys, values, low, mid);
+}
+
+//  quick_partition_block ͬĿ黮ֻ֣ȽϹؼ֣ʱͬһ𽻻
+template <typename Value>
+int partition_block_pairs(int* keys, Value* values, int low, int high)
+{
+	const int pivot = keys[low];
+	unsigned char offsetsLeft[PAIRS_PARTITION_BLOCK_SIZE];
+	unsigned char offsetsRight[PAIRS_PARTITION_BLOCK_SIZE];
+	int first = low + 1;	// δ [first, last)
+	int last = high + 1;
+	int startLeft = 0, numLeft = 0;
+	int startRight = 0, numRight = 0;
+	int i, num, sizeLeft, sizeRight, unknown;
+
+	while (last - first > 2 * PAIRS_PARTITION_BLOCK_SIZE) {
+		if (numLeft == 0) {
+			startLeft = 0;
+			for (i = 0; i < PAIRS_PARTITION_BLOCK_SIZE; ++i) {
+				offsetsLeft[numLeft] = (unsigned char)i;
+				numLeft += (keys[first + i] >= pivot);
+			}
+		}
+
+		if (numRight == 0) {
+			startRight = 0;
+			for (i = 0; i < PAIRS_PARTITION_BLOCK_SIZE; ++i) {
+				offsetsRight[numRight] = (unsigned char)i;
+				numRight += (keys[last - 1 - i] <= pivot);
+			}
+		}
+
+		num = (numLeft < numRight) ? numLeft : numRight;
+		for (i = 0; i < num; ++i) {
+			swap_pair(keys, values, first + offsetsLeft[startLeft + i],
+				last - 1 - offsetsRight[startRight + i]);
+		}
+
+		numLeft -= num;
+		numRight -= num;
+		startLeft += num;
+		startRight += num;
+
+		if (numLeft == 0) {
+			first += PAIRS_PARTITION_BLOCK_SIZE;
+		}
+
+		if (numRight == 0) {
+			last -= PAIRS_PARTITION_BLOCK_SIZE;
+		}
+	}
+
+	unknown = (last - first) - ((numLeft || numRight) ? PAIRS_PARTITION_BLOCK_SIZE : 0);
+	if (numRight) {
+		sizeLeft = unknown;
+		sizeRight = PAIRS_PARTITION_BLOCK_SIZE;
+	}
+	else if (numLeft) {
+		sizeLeft = PAIRS_PARTITION_BLOCK_SIZE;
+		sizeRight = unknown;
+	}
+	else {
+		sizeLeft = unknown / 2;
+		sizeRight = unknown - sizeLeft;
+	}
+
+	if (unknown && numLeft == 0) {
+		startLeft = 0;
+		for (i = 0; i < sizeLeft; ++i) {
+			offsetsLeft[numLeft] = (unsigned char)i;
+			numLeft += (keys[first + i] >= pivot);
+		}
+	}
+
+	if (unknown && numRight == 0) {
+		startRight = 0;
+		for (i = 0; i < sizeRight; ++i) {
+			offsetsRight[numRight] = (unsigned char)i;
+			numRight += (keys[last - 1 - i] <= pivot);
+		}
+	}
+
+	num = (numLeft < numRight) ? numLeft : numRight;
+	for (i = 0; i < num; ++i) {
+		swap_pair(keys, values, first + offsetsLeft[startLeft + i],
+			last - 1 - offsetsRight[startRight + i]);
+	}
+
+	numLeft -= num;
+	numRight -= num;
+	startLeft += num;
+	startRight += num;
+
+	if (numLeft == 0) {
+		first += sizeLeft;
+	}
+
+	if (numRight == 0) {
+		last -= sizeRight;
+	}
+
+	if (numLeft) {
+		while (numLeft--) {
+			swap_pair(keys, values, first + offsetsLeft[startLeft + numLeft], --last);
+		}
+		first = last;
+	}
+
+	if (numRight) {
+		while (numRight--) {
+			swap_pair(keys, values, last - 1 - offsetsRight[startRight + numRight], first++);
+		}
+		last = first;
+	}
+
+	swap_pair(keys, values, low, first - 1);
+
+	return first - 1;
+}
+
+//  [low, high] ʡ˻
+template <typename Value>
+void heap_sort_pairs(int* keys, Value* values, int low, int high)
+{
+	int length = high - low + 1;
+	int i, end, parent, child;
+
+	keys += low;
+	values += low;
+
+	for (i = length / 2 - 1; i >= 0; --i) {
+		for (parent = i; (child = 2 * parent + 1) < length; parent = child) {
+			if (child + 1 < length && keys[child] < keys[child + 1]) {
+				++child;
+			}
+			if (keys[parent] >= keys[child]) {
+				break;
+			}
+			swap_pair(keys, values, parent, child);
+		}
+	}
+
+	for (end = length - 1; end > 0; --end) {
+		swap_pair(keys, values, 0, end);
+
+		for (parent = 0; (child = 2 * parent + 1) < end; parent = child) {
+			if (child + 1 < end && keys[child] < keys[child + 1]) {
+				++child;
+			}
+			if (keys[parent] >= keys[child]) {
+				break;
+			}
+			swap_pair(keys, values, parent, child);
+		}
+	}
+}
+
+template <typename Value>
+void quick_sort_pairs_impl(int* keys, Value* values, int low, int high, int depthLimit)
+{
+	while (high - low + 1 > PAIRS_QUICK_CUTOFF) {
+		if (depthLimit-- == 0) {
+			heap_sort_pairs(keys, values, low, high);
+			return;
+		}
+
+		choose_pivot_pairs(keys, values, low, high);
+
+		int pivotPos = partition_block_pairs(keys, values, low, high);
+
+		if (pivotPos - low < high - pivotPos) {
+			quick_sort_pairs_impl(keys, values, low, pivotPos - 1, depthLimit);
+			low = pivotPos + 1;
+		}
+		else {
+			quick_sort_pairs_impl(keys, values, pivotPos + 1, high, depthLimit);
+			high = pivotPos - 1;
+		}
+	}
+
+	if (low < high) {
+		insert_sort_pairs(keys, values, low, high + 1);
+	}
+}
+
+template <typename Value>
+void quick_sort_pairs_start(int* keys, Value* values, int length)
+{
+	assert(keys && values && length >= 0);
+
+	int depthLimit = 0;
+	for (int n = length; n > 1; n >>= 1) {
+		depthLimit += 2;
+	}
+
+	quick_sort_pairs_impl(keys, values, 0, length - 1, depthLimit);
+}
+
+void quick_sort_pairs(int* keys, unsigned int* values, int length)
+{
+	quick_sort_pairs_start(keys, values, length);
+}
+
+void quick_sort_pairs(int* keys, unsigned long long* values, int length)
+{
+	quick_sort_pairs_start(keys, values, length);
+}
+
+
+//=========================================================
+//					
+//=========================================================
+
+// ƹؼ֣±Ϊ
+int* argsort_prepare(const int* keys, int length, int* index)
+{
+	assert(keys && index && length >= 0);
+
+	int* copy = (int*)malloc((length ? length : 1) * sizeof(int));
+	if (!copy) {
+		return NULL;
+	}
+
+	memcpy(copy, keys, length * sizeof(int));
+
+	for (int i = 0; i < length; ++i) {
+		index[i] = i;
+	}
+
+	return copy;
+}
+
+bool radix_argsort(const int* keys, int length, int* index)
+{
+	int* copy = argsort_prepare(keys, length, index);
+	if (!copy) {
+		return false;
+	}
+
+	bool ok = radix_sort_pairs(copy, (unsigned int*)index, length);
+
+	free(copy);
+
+	return ok;
+}
+
+bool merge_argsort(const int* keys, int length, int* index)
+{
+	int* copy = argsort_prepare(keys, length, index);
+	if (!copy) {
+		return false;
+	}
+
+	bool ok = merge_sort_pairs(copy, (unsigned int*)index, length);
+
+	free(copy);
+
+	return ok;
+}
+
+bool quick_argsort(const int* keys, int length, int* index)
+{
+	int* copy = argsort_prepare(keys, length, index);
+	if (!copy) {
+		return false;
+	}
+
+	quick_sort_pairs(copy, (unsigned int*)index, length);
+
+	free(copy);
+
+	return true;
+}
+
+
+//=========================================================
+//					
+//=========================================================
+
+// ת޷ȽϼΪ˳תλٰλȡ
+inline unsigned int column_key(int value, bool descending)
+{
+	return ((unsigned int)value ^ 0x80000000u) ^ (descending ? 0xFFFFFFFFu : 0);
+}
+
+// column_key 任
+inline int column_value(unsigned int key, bool descending)
+{
+	return (int)((key ^ (descending ? 0xFFFFFFFFu : 0)) ^ 0x80000000u);
+}
+
+// һǰУֻһؼʱΪһУźõĹؼ־⼸ֵ
+// sorted[k] Ϊ NULL ʱѵ k Уk < 2ֵд sorted[k]⼸вҪ
+bool columns_argsort_impl(const int* const* keys, int keyCount, const bool* descending,
+	size_t length, unsigned int* index, int* const* sorted)
+{
+	assert((keys || keyCount == 0) && (index || length == 0));
+	assert(length <= UINT_MAX);
+
+	unsigned long long* wideKeys;
+	unsigned long long* tempKeys;
+	unsigned int* tempIndex;
+	unsigned int* narrowKeys;
+	const int* high;
+	const int* low;
+	bool highDescending = false;
+	bool lowDescending = false;
+	bool identity = true;
+	int first = 0;
+	int last;
+	size_t i, row;
+
+	for (i = 0; i < length; ++i) {
+		index[i] = (unsigned int)i;
+	}
+
+	if (length < 2 || keyCount == 0) {
+		for (i = 0; sorted && i < length; ++i) {
+			for (int k = 0; k < keyCount && k < 2; ++k) {
+				if (sorted[k]) {
+					sorted[k][i] = keys[k][i];
+				}
+			}
+		}
+
+		return true;
+	}
+
+	wideKeys = (unsigned long long*)malloc(length * sizeof(unsigned long long));
+	tempKeys = (unsigned long long*)malloc(length * sizeof(unsigned long long));
+	tempIndex = (unsigned int*)malloc(length * sizeof(unsigned int));
+	if (!wideKeys || !tempKeys || !tempIndex) {
+		free(wideKeys);
+		free(tempKeys);
+		free(tempIndex);
+		return false;
+	}
+
+	narrowKeys = (unsigned int*)wideKeys;
+
+	// Ӻǰÿһ [first, last)Ϊʱһеһ飬
+	// ʹһǰ
+	for (last = keyCount; last > 0; last = first) {
+		first = (last == keyCount && keyCount % 2 != 0) ? last - 1 : last - 2;
+		high = keys[first];
+		highDescending = descending && descending[first];
+
+		if (last - first == 2) {
+			low = keys[first + 1];
+			lowDescending = descending && descending[first + 1];
+
+			for (i = 0; i < length; ++i) {
+				row = identity ? i : index[i];
+				wideKeys[i] = ((unsigned long long)column_key(high[row], highDescending) << 32)
+					| column_key(low[row], lowDescending);
+			}
+
+			radix_sort_pairs_impl<unsigned long long, 0>(wideKeys, index, tempKeys, tempIndex, length);
+		}
+		else {
+			for (i = 0; i < length; ++i) {
+				narrowKeys[i] = column_key(high[identity ? i : index[i]], highDescending);
+			}
+
+			radix_sort_pairs_impl<unsigned int, 0>(narrowKeys, index, (unsigned int*)tempKeys,
+				tempIndex, length);
+		}
+
+		identity = false;
+	}
+
+	// һΪ [0, 2)ֻһؼʱΪ [0, 1)
+	if (sorted && keyCount >= 2) {
+		for (i = 0; i < length; ++i) {
+			if (sorted[0]) {
+				sorted[0][i] = column_value((unsigned int)(wideKeys[i] >> 32), highDescending);
+			}
+			if (sorted[1]) {
+				sorted[1][i] = column_value((unsigned int)wideKeys[i], lowDescending);
+			}
+		}
+	}
+	else if (sorted && sorted[0]) {
+		for (i = 0; i < length; ++i) {
+			sorted[0][i] = column_value(narrowKeys[i], highDescending);
+		}
+	}
+
+	free(wideKeys);
+	free(tempKeys);
+	free(tempIndex);
+
+	return true;
+}
+
+bool columns_argsort(const int* const* keys, int keyCount, const bool* descending,
+	size_t length, unsigned int* index)
+{
+	return columns_argsort_impl(keys, keyCount, descending, length, index, NULL);
+}
+
+void columns_gather(const int* const* columns, int columnCount, const unsigned int* index,
+	size_t length, int* const* out)
+{
+	assert((columns && out) || columnCount == 0);
+	assert(index || length == 0);
+
+	const int* src;
+	int* dst;
+	size_t i;
+	int c;
+
+	// һֻһУнȡʱͬʱʵҳ࣬TLB ȱʧ࣬
+	for (c = 0; c < columnCount; ++c) {
+		src = columns[c];
+		dst = out[c];
+
+		for (i = 0; i < length; ++i) {
+			dst[i] = src[index[i]];
+		}
+	}
+}
+
+bool columns_sort(const int* const* columns, int columnCount, const int* keys, int keyCount,
+	const bool* descending, size_t length, int* const* out)
+{
+	assert((columns && out) || columnCount == 0);
+	assert(keys || keyCount == 0);
+
+	const int** keyColumns;
+	const int** gatherColumns;
+	int** gatherOut;
+	int* sorted[2] = {NULL, NULL};
+	unsigned int* index;
+	int decoded, gatherCount, c, k;
+	bool ok;
+
+	keyColumns = (const int**)malloc((keyCount > 0 ? keyCount : 1) * sizeof(const int*));
+	gatherColumns = (const int**)malloc((columnCount > 0 ? columnCount : 1) * sizeof(const int*));
+	gatherOut = (int**)malloc((columnCount > 0 ? columnCount : 1) * sizeof(int*));
+	index = (unsigned int*)malloc((length > 0 ? length : 1) * sizeof(unsigned int));
+	if (!keyColumns || !gatherColumns || !gatherOut || !index) {
+		free(keyColumns);
+		free(gatherColumns);
+		free(gatherOut);
+		free(index);
+		return false;
+	}
+
+	for (k = 0; k < keyCount; ++k) {
+		assert(keys[k] >= 0 && keys[k] < columnCount);
+		keyColumns[k] = columns[keys[k]];
+	}
+
+	// һؼֱźõĹؼֵõ
+	decoded = (keyCount < 2) ? keyCount : 2;
+	for (k = 0; k < decoded; ++k) {
+		sorted[k] = out[keys[k]];
+	}
+
+	gatherCount = 0;
+	for (c = 0; c < columnCount; ++c) {
+		if ((decoded > 0 && c == keys[0]) || (decoded > 1 && c == keys[1])) {
+			continue;
+		}
+
+		gatherColumns[gatherCount] = columns[c];
+		gatherOut[gatherCount++] = out[c];
+	}
+
+	ok = columns_argsort_impl(keyColumns, keyCount, descending, length, index, sorted);
+	if (ok) {
+		columns_gather(gatherColumns, gatherCount, index, length, gatherOut);
+	}
+
+	free(keyColumns);
+	free(gatherColumns);
+	free(gatherOut);
+	free(index);
+
+	return ok;
+}
@@ -0,0 +1,85 @@
+#ifndef __KEY_VALUE_SORT_H__
+#define __KEY_VALUE_SORT_H__
+
+#include <stddef.h>
+
+/**
+* ֵ򣺰 keys values жӦĸأ32 λ 64 λ¼š
+* ļƫơָ룩ؼһƶؼͬһ/鲢/ѭ
+* ƶһû
+* Լ¼ָñȽϺֻ˳飬û
+* ȱʧ
+* ᶯصĴ۲С100 ¼ʵ⣬32 λأ
+* ԼΪֻ int  1.3~1.6 64 λ 10%~30%鲢Ƚϣû
+* merge_sort  SIMD 鲢ԼΪ merge_sort  6 ҪȶʱӦ
+* radix_sort_pairs
+* quick_sort_pairs ȡ׼黮 quick_sort Ӧĸ
+* ʱһݸأ޸һʱҪͬ޸һ
+*
+* 		 keys  values ΪͬΪ length 
+* ֵ	 Ҫռڷʧʱ falseʱݱֲ
+*/
+
+// LSD ȶռ O(n)
+bool radix_sort_pairs(int* keys, unsigned int* values, int length);
+bool radix_sort_pairs(int* keys, unsigned long long* values, int length);
+
+// ϵĶ·鲢ȶռ O(n)
+bool merge_sort_pairs(int* keys, unsigned int* values, int length);
+bool merge_sort_pairs(int* keys, unsigned long long* values, int length);
+
+// ʡ򣨿黮֣ȶռ O(lgn)
+void quick_sort_pairs(int* keys, unsigned int* values, int length);
+void quick_sort_pairs(int* keys, unsigned long long* values, int length);
+
+
+/**
+* argsortƶ keys± index
+* ʹ keys[index[0]] <= keys[index[1]] <= ...
+* ʵΪ keys һݣ±Ϊֵ
+* radix_argsort  merge_argsort ȶģؼʱ±Сǰ
+*
+* 		 index ΪΪ length 飬ڴŽ
+* ֵ	 ռʧʱ false
+*/
+bool radix_argsort(const int* keys, int length, int* index);
+
+bool merge_argsort(const int* keys, int length, int* index);
+
+bool quick_argsort(const int* keys, int length, int* index);
+
+
+/**
+* ORDER BY keys[0], keys[1], ...¼дţÿһΪ
+* length  int 顣
+*
+* columns_argsort ±Уѹؼÿƴһ 64 λ
+* ؼ֣ 32 λΪǰһУΪʱһеһ飩жת
+* Ϊ޷ȽϼΪ˳ʽתλʱٰλȡ
+* Ȱһȶ LSD ΰǰȶ򡣸
+* м¼ֽͬڲֵСֻһˡһֱ˳
+* У鰴ǰ±жȡ
+*
+* columns_gather ±ŸУһֻһСȡĴҪ
+*  TLB ȱʧзֿ齻ȡУ±ڻУʵⷴ
+* columns_sort һ飨ǰУźõĹؼ־
+* ֱֵ任дҪš
+*
+* ȶģйؼֶͬļ¼ԭ˳
+* 		 descending Ϊ NULL ʱȫ򣬷 descending[k] ʾ k ؼֽ
+*             length ܳ UINT_MAX
+* ֵ	 ռʧʱ false
+*/
+bool columns_argsort(const int* const* keys, int keyCount, const bool* descending,
+	size_t length, unsigned int* index);
+
+// out[c][i] = columns[c][index[i]]out  columns ص
+void columns_gather(const int* const* columns, int columnCount, const unsigned int* index,
+	size_t length, int* const* out);
+
+//  columns[keys[0]], columns[keys[1]], ... Уд out жӦС
+// keys Ϊؼ columns е
+bool columns_sort(const int* const* columns, int columnCount, const int* keys, int keyCount,
+	const bool* descending, size_t length, int* const* out);
+
+#endif // __KEY_VALUE_SORT_H__
@@ -0,0 +1,1557 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <memory.h>
+#include <assert.h>
+#include <limits.h>
+
+#include "SortAlgorithms.h"
+#include "SimdSort.h"
+#include "TaskScheduler.h"
+#include "Heap.h"
+#include "ParallelSort.h"
+
+// SortAlgorithms.cpp пڲ
+void quick_choose_pivot(int* array, int low, int high);
+bool quick_sort_presorted(int* array, int low, int high);
+
+// SortAlgorithms.cpp мڲ
+bool counting_sort_range_fits(unsigned long long range, size_t length);
+void counting_histogram(const int* array, size_t length, int minValue, size_t range, size_t* counts);
+
+// SortAlgorithms.cpp ڲ
+int sample_sort_build_splitters(const int* array, size_t length, int logBuckets,
+	int* tree, int* splitters, bool* equal);
+void sample_sort_classify(const int* array, size_t length, const int* tree, const int* splitters,
+	int logBuckets, bool equal, unsigned char* oracle, size_t* counts);
+void sample_sort_impl(int* array, int* temp, unsigned char* oracle, size_t length);
+
+//=========================================================
+//					п
+//=========================================================
+
+// 䳤Ȳڸֵʱֱӵôе quick_sort
+#define PARALLEL_QUICK_SORT_GRAIN		(1 << 15)
+
+// 䳤ȲСڸֵʱʹòл
+#define PARALLEL_PARTITION_THRESHOLD	(1 << 20)
+
+// лÿС
+#define PARALLEL_PARTITION_BLOCK_MIN	(1 << 17)
+
+// лֵ
+#define PARALLEL_PARTITION_MAX_BLOCKS	256
+
+// н׶ÿٽļ¼
+#define PARALLEL_SWAP_MIN				(1 << 15)
+
+struct Quick_Sort_Context {
+	int* array;
+	Quick_Partition_Scheme scheme;
+	Partition_Function partition;
+};
+
+// һβлֵ״̬һ׶ͷ
+struct Parallel_Partition {
+	int* array;
+	size_t begin;
+	size_t end;
+	int depth;
+	int pivot;
+	bool lessEqual;		// true <= pivot ֣false < pivot 
+	int blocks;
+	size_t blockSize;
+	size_t leftCount[PARALLEL_PARTITION_MAX_BLOCKS];	// 黮ֺļ¼
+	size_t middle;		// ֵ㣺[begin, middle) Ϊ࣬[middle, end) ΪҲ
+	Quick_Sort_Context* context;
+	Task_Join join;
+};
+
+void parallel_quick_sort_task(Task_Worker* worker, const Task* task);
+void parallel_partition_start(Task_Worker* worker, Parallel_Partition* partition);
+
+inline int median3(int a, int b, int c)
+{
+	if (a < b) {
+		return (b < c) ? b : ((a < c) ? c : a);
+	}
+	else {
+		return (a < c) ? a : ((b < c) ? c : b);
+	}
+}
+
+// ȡѡȡ׼ֵƶ¼
+int parallel_choose_pivot(const int* array, size_t begin, size_t end)
+{
+	size_t step = (end - begin) / 9;
+	const int* p = array + begin;
+
+	return median3(
+		median3(p[0], p[step], p[2 * step]),
+		median3(p[3 * step], p[4 * step], p[5 * step]),
+		median3(p[6 * step], p[7 * step], p[8 * step]));
+}
+
+inline bool partition_goes_left(int value, int pivot, bool lessEqual)
+{
+	return lessEqual ? (value <= pivot) : (value < pivot);
+}
+
+size_t block_begin(const Parallel_Partition* partition, int block)
+{
+	return partition->begin + block * partition->blockSize;
+}
+
+size_t block_end(const Parallel_Partition* partition, int block)
+{
+	return (block == partition->blocks - 1)
+		? partition->end
+		: partition->begin + (block + 1) * partition->blockSize;
+}
+
+// һ׶Σ
+void parallel_partition_block_task(Task_Worker* /* worker */, const Task* task)
+{
+	Parallel_Partition* partition = (Parallel_Partition*)task->context;
+	int* array = partition->array;
+	int pivot = partition->pivot;
+	bool lessEqual = partition->lessEqual;
+	int block = (int)task->begin;
+
+	size_t low = block_begin(partition, block);
+	size_t high = block_end(partition, block);
+	size_t first = low;
+	size_t i;
+	int temp;
+
+	if (partition->context->scheme == QUICK_PARTITION_BLOCK) {
+		// ޷֧ Lomuto ֣[first, low) ࣬[low, i) Ҳࡣ
+		// ÿ¼ [low] ȽϽֻ low Ƿǰ
+		if (lessEqual) {
+			for (i = first; i < high; ++i) {
+				temp = array[i];
+				array[i] = array[low];
+				array[low] = temp;
+				low += (temp <= pivot);
+			}
+		}
+		else {
+			for (i = first; i < high; ++i) {
+				temp = array[i];
+				array[i] = array[low];
+				array[low] = temp;
+				low += (temp < pivot);
+			}
+		}
+
+		partition->leftCount[block] = low - first;
+		return;
+	}
+
+	// [first, low) ࣬[high, end) Ҳ
+	while (low < high) {
+		if (partition_goes_left(array[low], pivot, lessEqual)) {
+			++low;
+		}
+		else if (!partition_goes_left(array[high - 1], pivot, lessEqual)) {
+			--high;
+		}
+		else {
+			temp = array[low];
+			array[low++] = array[high - 1];
+			array[--high] = temp;
+		}
+	}
+
+	partition->leftCount[block] = low - first;
+}
+
+//  k λ¼е k Ҳļ¼
+// Ҳе k ļ¼
+//  k λڵĿ鼰ƫơ
+void locate_misplaced(const Parallel_Partition* partition, bool inLeftRegion,
+	size_t k, int* block, size_t* pos)
+{
+	size_t i, first, last, count;
+
+	for (i = 0; i < (size_t)partition->blocks; ++i) {
+		if (inLeftRegion) {
+			// ҲĲ [begin, middle) Ľ
+			first = block_begin(partition, (int)i) + partition->leftCount[i];
+			last = block_end(partition, (int)i);
+			if (last > partition->middle) {
+				last = partition->middle;
+			}
+		}
+		else {
+			// Ĳ [middle, end) Ľ
+			first = block_begin(partition, (int)i);
+			last = first + partition->leftCount[i];
+			if (first < partition->middle) {
+				first = partition->middle;
+			}
+		}
+
+		count = (last > first) ? last - first : 0;
+		if (k < count) {
+			*block = (int)i;
+			*pos = first + k;
+			return;
+		}
+
+		k -= count;
+	}
+
+	*block = partition->blocks;
+	*pos = partition->end;
+}
+
+// ȡһλ¼λãblock/pos Ϊǰλ
+void next_misplaced(const Parallel_Partition* partition, bool inLeftRegion,
+	int* block, size_t* pos)
+{
+	++(*pos);
+
+	for (;;) {
+		size_t first, last;
+		int i = *block;
+
+		if (inLeftRegion) {
+			first = block_begin(partition, i) + partition->leftCount[i];
+			last = block_end(partition, i);
+			if (last > partition->middle) {
+				last = partition->middle;
+			}
+		}
+		else {
+			first = block_begin(partition, i);
+			last = first + partition->leftCount[i];
+			if (first < partition->middle) {
+				first = partition->middle;
+			}
+		}
+
+		if (*pos < first) {
+			*pos = first;
+		}
+
+		if (*pos < last || i + 1 >= partition->blocks) {
+			return;
+		}
+
+		*block = i + 1;
+	}
+}
+
+// ڶ׶Σ [begin, end) λ¼
+void parallel_partition_swap_task(Task_Worker* /* worker */, const Task* task)
+{
+	Parallel_Partition* partition = (Parallel_Partition*)task->context;
+	int* array = partition->array;
+	int leftBlock, rightBlock;
+	size_t leftPos, rightPos, k;
+	int temp;
+
+	locate_misplaced(partition, true, task->begin, &leftBlock, &leftPos);
+	locate_misplaced(partition, false, task->begin, &rightBlock, &rightPos);
+
+	for (k = task->begin; k < task->end; ++k) {
+		temp = array[leftPos];
+		array[leftPos] = array[rightPos];
+		array[rightPos] = temp;
+
+		if (k + 1 < task->end) {
+			next_misplaced(partition, true, &leftBlock, &leftPos);
+			next_misplaced(partition, false, &rightBlock, &rightPos);
+		}
+	}
+}
+
+// ׶Σ
+void parallel_partition_finish_task(Task_Worker* worker, const Task* task)
+{
+	Parallel_Partition* partition = (Parallel_Partition*)task->context;
+	Task sub;
+
+	// ׼СֵΪգΪ <= pivot »֣
+	// ȫڻ׼
+	if (partition->middle == partition->begin && !partition->lessEqual) {
+		partition->lessEqual = true;
+		parallel_partition_start(worker, partition);
+		return;
+	}
+
+	sub.func = parallel_quick_sort_task;
+	sub.context = partition->context;
+	sub.level = partition->depth - 1;
+	sub.join = NULL;
+
+	if (!partition->lessEqual) {
+		sub.begin = partition->begin;
+		sub.end = partition->middle;
+		task_spawn(worker, &sub);
+	}
+
+	sub.begin = partition->middle;
+	sub.end = partition->end;
+	task_spawn(worker, &sub);
+
+	free(partition);
+}
+
+// ڶ׶֮ǰͳƻֵ㣬
+void parallel_partition_count_task(Task_Worker* worker, const Task* task)
+{
+	Parallel_Partition* partition = (Parallel_Partition*)task->context;
+	size_t i, misplaced, chunk, swaps;
+	Task swap, finish;
+
+	partition->middle = partition->begin;
+	for (i = 0; i < (size_t)partition->blocks; ++i) {
+		partition->middle += partition->leftCount[i];
+	}
+
+	//  [begin, middle) Ҳļ¼
+	misplaced = 0;
+	for (i = 0; i < (size_t)partition->blocks; ++i) {
+		size_t first = block_begin(partition, (int)i) + partition->leftCount[i];
+		size_t last = block_end(partition, (int)i);
+		if (last > partition->middle) {
+			last = partition->middle;
+		}
+
+		if (last > first) {
+			misplaced += last - first;
+		}
+	}
+
+	finish.func = parallel_partition_finish_task;
+	finish.context = partition;
+	finish.begin = finish.end = 0;
+	finish.level = 0;
+	finish.join = NULL;
+
+	if (misplaced == 0) {
+		task_spawn(worker, &finish);
+		return;
+	}
+
+	swaps = (misplaced + PARALLEL_SWAP_MIN - 1) / PARALLEL_SWAP_MIN;
+	if (swaps > (size_t)partition->blocks) {
+		swaps = partition->blocks;
+	}
+	chunk = (misplaced + swaps - 1) / swaps;
+	swaps = (misplaced + chunk - 1) / chunk;
+
+	task_join_init(&partition->join, (long)swaps, &finish);
+
+	swap.func = parallel_partition_swap_task;
+	swap.context = partition;
+	swap.level = 0;
+	swap.join = &partition->join;
+
+	for (i = 0; i < swaps; ++i) {
+		swap.begin = i * chunk;
+		swap.end = (i + 1 == swaps) ? misplaced : (i + 1) * chunk;
+		task_spawn(worker, &swap);
+	}
+}
+
+// һ׶εķֿ黮
+void parallel_partition_start(Task_Worker* worker, Parallel_Partition* partition)
+{
+	int i;
+	Task block, count;
+
+	count.func = parallel_partition_count_task;
+	count.context = partition;
+	count.begin = count.end = 0;
+	count.level = 0;
+	count.join = NULL;
+
+	task_join_init(&partition->join, partition->blocks, &count);
+
+	block.func = parallel_partition_block_task;
+	block.context = partition;
+	block.end = 0;
+	block.level = 0;
+	block.join = &partition->join;
+
+	for (i = 0; i < partition->blocks; ++i) {
+		block.begin = i;
+		task_spawn(worker, &block);
+	}
+}
+
+// ȳ INT_MAX 䲻ܽ quick_sortþ޷лʱ
+//  size_t ±򣬱֤ O(nlgn)
+void parallel_heap_sort(int* array, size_t length)
+{
+	size_t i;
+
+	max_heap_build(array, length);
+	for (i = length; i > 1; --i) {
+		max_heap_pop(array, i);
+	}
+}
+
+//  [task->begin, task->end) task->level ΪʣĻ
+void parallel_quick_sort_task(Task_Worker* worker, const Task* task)
+{
+	Quick_Sort_Context* context = (Quick_Sort_Context*)task->context;
+	int* array = context->array;
+	size_t begin = task->begin;
+	size_t end = task->end;
+	int depth = task->level;
+	Task sub;
+
+	sub.func = parallel_quick_sort_task;
+	sub.context = context;
+	sub.join = NULL;
+
+	while (end - begin > PARALLEL_QUICK_SORT_GRAIN) {
+		size_t length = end - begin;
+
+		if (length <= INT_MAX
+			&& quick_sort_presorted(array + begin, 0, (int)length - 1)) {
+			return;
+		}
+
+		// þʱ quick_sortڲתΪ
+		if (depth <= 0) {
+			if (length <= INT_MAX) {
+				break;
+			}
+
+			parallel_heap_sort(array + begin, length);
+			return;
+		}
+
+		if (length >= PARALLEL_PARTITION_THRESHOLD) {
+			Parallel_Partition* partition =
+				(Parallel_Partition*)malloc(sizeof(Parallel_Partition));
+
+			if (partition) {
+				size_t blocks = length / PARALLEL_PARTITION_BLOCK_MIN;
+				if (blocks > (size_t)task_worker_count(worker)) {
+					blocks = task_worker_count(worker);
+				}
+				if (blocks > PARALLEL_PARTITION_MAX_BLOCKS) {
+					blocks = PARALLEL_PARTITION_MAX_BLOCKS;
+				}
+				if (blocks < 1) {
+					blocks = 1;
+				}
+
+				partition->array = array;
+				partition->begin = begin;
+				partition->end = end;
+				partition->depth = depth;
+				partition->pivot = parallel_choose_pivot(array, begin, end);
+				partition->lessEqual = false;
+				partition->blocks = (int)blocks;
+				partition->blockSize = length / blocks;
+				partition->context = context;
+
+				parallel_partition_start(worker, partition);
+				return;
+			}
+
+			// ޷ int ±괮л
+			if (length > INT_MAX) {
+				parallel_heap_sort(array + begin, length);
+				return;
+			}
+		}
+
+		// л֣ϳһȥ߳ȡ϶̵һ
+		int low = 0;
+		int high = (int)length - 1;
+		int pivotPos;
+
+		quick_choose_pivot(array + begin, low, high);
+		pivotPos = context->partition(array + begin, low, high);
+		--depth;
+
+		sub.level = depth;
+		if ((size_t)pivotPos < length - pivotPos - 1) {
+			sub.begin = begin + pivotPos + 1;
+			sub.end = end;
+			end = begin + pivotPos;
+		}
+		else {
+			sub.begin = begin;
+			sub.end = begin + pivotPos;
+			begin = begin + pivotPos + 1;
+		}
+
+		task_spawn(worker, &sub);
+	}
+
+	if (end - begin > 1) {
+		quick_sort_ex(array + begin, (int)(end - begin), context->scheme);
+	}
+}
+
+void parallel_quick_sort(int* array, size_t length, int threads)
+{
+	parallel_quick_sort_ex(array, length, threads, QUICK_PARTITION_BLOCK);
+}
+
+void parallel_quick_sort_ex(int* array, size_t length, int threads,
+	Quick_Partition_Scheme scheme)
+{
+	assert(array || length == 0);
+
+	if (length <= 1) {
+		return;
+	}
+
+	Quick_Sort_Context context;
+	Task root;
+	int depth = 0;
+	size_t n;
+
+	for (n = length; n > 1; n >>= 1) {
+		depth += 2;
+	}
+
+	context.array = array;
+	context.scheme = scheme;
+	context.partition = quick_partition_function(scheme);
+
+	root.func = parallel_quick_sort_task;
+	root.context = &context;
+	root.begin = 0;
+	root.end = length;
+	root.level = depth;
+	root.join = NULL;
+
+	task_scheduler_run(threads, &root);
+}
+
+
+//=========================================================
+//					й鲢
+//=========================================================
+
+// 䳤ȲڸֵʱֱӵôеĹ鲢
+#define PARALLEL_MERGE_SORT_GRAIN		(1 << 14)
+
+// й鲢ʱÿС
+#define PARALLEL_MERGE_SEGMENT_MIN		(1 << 15)
+
+struct Merge_Sort_Context {
+	int* array;
+	int* temp;
+};
+
+// ڲ㣺źú󣬰Ǵһ鲢һ
+struct Merge_Sort_Node {
+	Merge_Sort_Context* context;
+	size_t begin;
+	size_t mid;
+	size_t end;
+	bool toTemp;			//  temp У array 
+	Task_Join childrenJoin;	// 䶼źúʼ鲢
+	Task_Join mergeJoin;	// ζ鲢
+	Task_Join* parentJoin;	// ɺ֪ͨ
+};
+
+// ȶع鲢 a[0, na)  b[0, nb)  outʱȡ a еļ¼
+void merge_runs(const int* a, size_t na, const int* b, size_t nb, int* out)
+{
+	simd_merge(a, na, b, nb, out);
+}
+
+// merge pathco-rank鲢ǰ diagonal ¼ a ĸ i
+//  a[i - 1] <= b[j]  b[j - 1] < a[i]j = diagonal - i
+// ʱ a еļ¼ǰ֤鲢ȶġ
+size_t merge_path_co_rank(const int* a, size_t na, const int* b, size_t nb, size_t diagonal)
+{
+	size_t low = (diagonal > nb) ? diagonal - nb : 0;
+	size_t high = (diagonal < na) ? diagonal : na;
+
+	while (low < high) {
+		size_t i = low + (high - low) / 2;
+		size_t j = diagonal - i;
+
+		if (j > 0 && i < na && b[j - 1] >= a[i]) {
+			low = i + 1;		// i ̫С
+		}
+		else {
+			high = i;
+		}
+	}
+
+	return low;
+}
+
+void parallel_merge_sort_task(Task_Worker* worker, const Task* task);
+
+// еذ [begin, end)  arraytoTemp Ϊ false temptoTemp Ϊ true
+void merge_sort_range(Merge_Sort_Context* context, size_t begin, size_t end, bool toTemp)
+{
+	size_t length = end - begin;
+
+	if (length <= PARALLEL_MERGE_SORT_GRAIN) {
+		merge_sort_dc(context->array + begin, (int)length, context->temp + begin);
+
+		if (toTemp) {
+			memcpy(context->temp + begin, context->array + begin, length * sizeof(int));
+		}
+		return;
+	}
+
+	size_t mid = begin + length / 2;
+	const int* src = toTemp ? context->array : context->temp;
+	int* dst = toTemp ? context->temp : context->array;
+
+	merge_sort_range(context, begin, mid, !toTemp);
+	merge_sort_range(context, mid, end, !toTemp);
+
+	merge_runs(src + begin, mid - begin, src + mid, end - mid, dst + begin);
+}
+
+// ɣͷŽ㣬task_execute ֪ͨ
+void parallel_merge_done_task(Task_Worker* /* worker */, const Task* task)
+{
+	free(task->context);
+}
+
+// 鲢еĵ [task->begin, task->end) ¼
+void parallel_merge_segment_task(Task_Worker* /* worker */, const Task* task)
+{
+	Merge_Sort_Node* node = (Merge_Sort_Node*)task->context;
+	const int* src = node->toTemp ? node->context->array : node->context->temp;
+	int* dst = node->toTemp ? node->context->temp : node->context->array;
+
+	const int* a = src + node->begin;
+	const int* b = src + node->mid;
+	size_t na = node->mid - node->begin;
+	size_t nb = node->end - node->mid;
+
+	size_t i0 = merge_path_co_rank(a, na, b, nb, task->begin);
+	size_t i1 = merge_path_co_rank(a, na, b, nb, task->end);
+	size_t j0 = task->begin - i0;
+	size_t j1 = task->end - i1;
+
+	merge_runs(a + i0, i1 - i0, b + j0, j1 - j0, dst + node->begin + task->begin);
+}
+
+// źã merge path ѹ鲢ƽֳɶβй鲢
+void parallel_merge_start_task(Task_Worker* worker, const Task* task)
+{
+	Merge_Sort_Node* node = (Merge_Sort_Node*)task->context;
+	size_t length = node->end - node->begin;
+	size_t segments = length / PARALLEL_MERGE_SEGMENT_MIN;
+	size_t i;
+	Task segment, done;
+
+	if (segments > (size_t)task_worker_count(worker)) {
+		segments = task_worker_count(worker);
+	}
+	if (segments < 1) {
+		segments = 1;
+	}
+
+	done.func = parallel_merge_done_task;
+	done.context = node;
+	done.begin = done.end = 0;
+	done.level = 0;
+	done.join = node->parentJoin;
+
+	task_join_init(&node->mergeJoin, (long)segments, &done);
+
+	segment.func = parallel_merge_segment_task;
+	segment.context = node;
+	segment.level = 0;
+	segment.join = &node->mergeJoin;
+
+	for (i = 0; i < segments; ++i) {
+		segment.begin = length * i / segments;
+		segment.end = length * (i + 1) / segments;
+		task_spawn(worker, &segment);
+	}
+}
+
+//  [task->begin, task->end)  arraytask->level Ϊ 0 temptask->level Ϊ 1
+void parallel_merge_sort_task(Task_Worker* worker, const Task* task)
+{
+	Merge_Sort_Context* context = (Merge_Sort_Context*)task->context;
+	size_t begin = task->begin;
+	size_t end = task->end;
+	bool toTemp = (task->level != 0);
+	size_t length = end - begin;
+
+	if (length <= PARALLEL_MERGE_SORT_GRAIN) {
+		merge_sort_range(context, begin, end, toTemp);
+		return;
+	}
+
+	Merge_Sort_Node* node = (Merge_Sort_Node*)malloc(sizeof(Merge_Sort_Node));
+	if (!node) {
+		merge_sort_range(context, begin, end, toTemp);
+		return;
+	}
+
+	node->context = context;
+	node->begin = begin;
+	node->mid = begin + length / 2;
+	node->end = end;
+	node->toTemp = toTemp;
+	node->parentJoin = task->join;
+
+	// 񷵻ʱ㻹ûɣƳٶԸ֪ͨ done ֪ͨ
+	if (node->parentJoin) {
+		task_join_add(node->parentJoin, 1);
+	}
+
+	Task merge, sub;
+
+	merge.func = parallel_merge_start_task;
+	merge.context = node;
+	merge.begin = merge.end = 0;
+	merge.level = 0;
+	merge.join = NULL;
+
+	task_join_init(&node->childrenJoin, 2, &merge);
+
+	// һٹ鲢
+	sub.func = parallel_merge_sort_task;
+	sub.context = context;
+	sub.level = toTemp ? 0 : 1;
+	sub.join = &node->childrenJoin;
+
+	sub.begin = node->mid;
+	sub.end = end;
+	task_spawn(worker, &sub);
+
+	sub.begin = begin;
+	sub.end = node->mid;
+	task_spawn(worker, &sub);
+}
+
+bool parallel_merge_sort(int* array, size_t length, int threads)
+{
+	assert(array || length == 0);
+
+	if (length <= PARALLEL_MERGE_SORT_GRAIN) {
+		return merge_sort_dc(array, (int)length);
+	}
+
+	Merge_Sort_Context context;
+	Task root;
+
+	context.array = array;
+	context.temp = (int*)malloc(length * sizeof(int));
+	if (!context.temp) {
+		return false;
+	}
+
+	root.func = parallel_merge_sort_task;
+	root.context = &context;
+	root.begin = 0;
+	root.end = length;
+	root.level = 0;
+	root.join = NULL;
+
+	task_scheduler_run(threads, &root);
+
+	free(context.temp);
+
+	return true;
+}
+
+
+//=========================================================
+//					л
+//=========================================================
+
+// ¼ڸֵʱֱӵôе radix_sort
+#define PARALLEL_RADIX_SORT_GRAIN	(1 << 16)
+
+#define PARALLEL_RADIX_BITS			8
+#define PARALLEL_RADIX_BUCKETS		(1 << PARALLEL_RADIX_BITS)
+#define PARALLEL_RADIX_MASK			(PARALLEL_RADIX_BUCKETS - 1)
+#define PARALLEL_RADIX_PASSES		(32 / PARALLEL_RADIX_BITS)
+
+// ÿͰдϲС¼16  int  64 ֽڣ뻺һ
+#define PARALLEL_RADIX_WC_SIZE		16
+
+struct Radix_Sort_Context {
+	unsigned int* array;
+	unsigned int* temp;
+	size_t length;
+	int chunks;						// ֿÿһ
+	size_t* counts;					// [chunk][digit]Ͱǰ׺֮ΪڸͰеʼλ
+	size_t passCounts[PARALLEL_RADIX_PASSES][PARALLEL_RADIX_BUCKETS];	// ȫ¼ڸ˵Ͱ
+	int passes[PARALLEL_RADIX_PASSES];	// Ҫִеˣȫͬˣ
+	int passCount;
+	int pass;						// ǰִе passes еĵڼ
+	unsigned int* src;
+	unsigned int* dst;
+	Task_Join join;
+};
+
+inline unsigned int radix_digit(unsigned int key, int shift)
+{
+	return ((key ^ 0x80000000u) >> shift) & PARALLEL_RADIX_MASK;
+}
+
+size_t radix_chunk_begin(const Radix_Sort_Context* context, int chunk)
+{
+	return context->length * chunk / context->chunks;
+}
+
+void parallel_radix_histogram_task(Task_Worker* worker, const Task* task);
+void parallel_radix_prefix_task(Task_Worker* worker, const Task* task);
+
+//  chunks task.begin Ϊţȫɺִ next
+void parallel_spawn_chunks(Task_Worker* worker, void* context, Task_Join* join, int chunks,
+	Task_Function func, Task_Function next)
+{
+	Task task, continuation;
+	int i;
+
+	continuation.func = next;
+	continuation.context = context;
+	continuation.begin = continuation.end = 0;
+	continuation.level = 0;
+	continuation.join = NULL;
+
+	task_join_init(join, chunks, &continuation);
+
+	task.func = func;
+	task.context = context;
+	task.end = 0;
+	task.level = 0;
+	task.join = join;
+
+	for (i = 0; i < chunks; ++i) {
+		task.begin = i;
+		task_spawn(worker, &task);
+	}
+}
+
+void parallel_radix_spawn_chunks(Task_Worker* worker, Radix_Sort_Context* context,
+	Task_Function func, Task_Function next)
+{
+	parallel_spawn_chunks(worker, context, &context->join, context->chunks, func, next);
+}
+
+// һζݣͳƱ˵Ͱ
+void parallel_radix_count_all_task(Task_Worker* /* worker */, const Task* task)
+{
+	Radix_Sort_Context* context = (Radix_Sort_Context*)task->context;
+	int chunk = (int)task->begin;
+	size_t begin = radix_chunk_begin(context, chunk);
+	size_t end = radix_chunk_begin(context, chunk + 1);
+	size_t* counts = context->counts + chunk * PARALLEL_RADIX_PASSES * PARALLEL_RADIX_BUCKETS;
+	size_t i;
+	int p;
+	unsigned int key;
+
+	memset(counts, 0, PARALLEL_RADIX_PASSES * PARALLEL_RADIX_BUCKETS * sizeof(size_t));
+
+	for (i = begin; i < end; ++i) {
+		key = context->array[i];
+
+		for (p = 0; p < PARALLEL_RADIX_PASSES; ++p) {
+			++counts[p * PARALLEL_RADIX_BUCKETS + radix_digit(key, p * PARALLEL_RADIX_BITS)];
+		}
+	}
+}
+
+// пļȷҪִе
+void parallel_radix_plan_task(Task_Worker* worker, const Task* task)
+{
+	Radix_Sort_Context* context = (Radix_Sort_Context*)task->context;
+	size_t* counts;
+	int i, p, d;
+	unsigned int first = context->array[0];
+
+	memset(context->passCounts, 0, sizeof(context->passCounts));
+
+	for (i = 0; i < context->chunks; ++i) {
+		counts = context->counts + i * PARALLEL_RADIX_PASSES * PARALLEL_RADIX_BUCKETS;
+
+		for (p = 0; p < PARALLEL_RADIX_PASSES; ++p) {
+			for (d = 0; d < PARALLEL_RADIX_BUCKETS; ++d) {
+				context->passCounts[p][d] += counts[p * PARALLEL_RADIX_BUCKETS + d];
+			}
+		}
+	}
+
+	context->passCount = 0;
+	for (p = 0; p < PARALLEL_RADIX_PASSES; ++p) {
+		if (context->passCounts[p][radix_digit(first, p * PARALLEL_RADIX_BITS)] != context->length) {
+			context->passes[context->passCount++] = p;
+		}
+	}
+
+	context->pass = 0;
+	context->src = context->array;
+	context->dst = context->temp;
+
+	if (context->passCount == 0) {
+		return;
+	}
+
+	// һִ֮ǰݻûƶͰֱʹ
+	p = context->passes[0];
+	for (i = 0; i < context->chunks; ++i) {
+		memmove(context->counts + i * PARALLEL_RADIX_BUCKETS,
+			context->counts + (i * PARALLEL_RADIX_PASSES + p) * PARALLEL_RADIX_BUCKETS,
+			PARALLEL_RADIX_BUCKETS * sizeof(size_t));
+	}
+
+	Task prefix;
+	prefix.func = parallel_radix_prefix_task;
+	prefix.context = context;
+	prefix.begin = prefix.end = 0;
+	prefix.level = 0;
+	prefix.join = NULL;
+	task_spawn(worker, &prefix);
+}
+
+// ͳƱڵǰ˵Ͱ
+void parallel_radix_histogram_task(Task_Worker* /* worker */, const Task* task)
+{
+	Radix_Sort_Context* context = (Radix_Sort_Context*)task->context;
+	int chunk = (int)task->begin;
+	int shift = context->passes[context->pass] * PARALLEL_RADIX_BITS;
+	size_t begin = radix_chunk_begin(context, chunk);
+	size_t end = radix_chunk_begin(context, chunk + 1);
+	size_t* counts = context->counts + chunk * PARALLEL_RADIX_BUCKETS;
+	const unsigned int* src = context->src;
+	size_t i;
+
+	memset(counts, 0, PARALLEL_RADIX_BUCKETS * sizeof(size_t));
+
+	for (i = begin; i < end; ++i) {
+		++counts[radix_digit(src[i], shift)];
+	}
+}
+
+// ѱļ¼䵽 dst СдÿͰдϲܹ 16 ¼
+// һддλ dst + offsets[d] ûж룬һοܿУı߽
+// ߳ԿдͬһУɢдö˺ܶࡣ
+void parallel_radix_scatter_task(Task_Worker* /* worker */, const Task* task)
+{
+	Radix_Sort_Context* context = (Radix_Sort_Context*)task->context;
+	int chunk = (int)task->begin;
+	int shift = context->passes[context->pass] * PARALLEL_RADIX_BITS;
+	size_t begin = radix_chunk_begin(context, chunk);
+	size_t end = radix_chunk_begin(context, chunk + 1);
+	size_t* offsets = context->counts + chunk * PARALLEL_RADIX_BUCKETS;
+	const unsigned int* src = context->src;
+	unsigned int* dst = context->dst;
+
+	unsigned int buffer[PARALLEL_RADIX_BUCKETS][PARALLEL_RADIX_WC_SIZE];
+	int used[PARALLEL_RADIX_BUCKETS];
+	size_t i;
+	unsigned int d, key;
+
+	memset(used, 0, sizeof(used));
+
+	for (i = begin; i < end; ++i) {
+		key = src[i];
+		d = radix_digit(key, shift);
+
+		buffer[d][used[d]++] = key;
+
+		if (used[d] == PARALLEL_RADIX_WC_SIZE) {
+			memcpy(dst + offsets[d], buffer[d], PARALLEL_RADIX_WC_SIZE * sizeof(unsigned int));
+			offsets[d] += PARALLEL_RADIX_WC_SIZE;
+			used[d] = 0;
+		}
+	}
+
+	for (d = 0; d < PARALLEL_RADIX_BUCKETS; ++d) {
+		if (used[d] > 0) {
+			memcpy(dst + offsets[d], buffer[d], used[d] * sizeof(unsigned int));
+		}
+	}
+}
+
+// ƻ arrayִʱ
+void parallel_radix_copy_task(Task_Worker* /* worker */, const Task* task)
+{
+	Radix_Sort_Context* context = (Radix_Sort_Context*)task->context;
+	int chunk = (int)task->begin;
+	size_t begin = radix_chunk_begin(context, chunk);
+	size_t end = radix_chunk_begin(context, chunk + 1);
+
+	memcpy(context->array + begin, context->temp + begin, (end - begin) * sizeof(unsigned int));
+}
+
+// һ˷ɣ src  dstʼһ
+void parallel_radix_next_task(Task_Worker* worker, const Task* task)
+{
+	Radix_Sort_Context* context = (Radix_Sort_Context*)task->context;
+	unsigned int* swap = context->src;
+
+	context->src = context->dst;
+	context->dst = swap;
+
+	if (++context->pass < context->passCount) {
+		parallel_radix_spawn_chunks(worker, context,
+			parallel_radix_histogram_task, parallel_radix_prefix_task);
+	}
+	else if (context->src != context->array) {
+		Task copy;
+		int i;
+
+		copy.func = parallel_radix_copy_task;
+		copy.context = context;
+		copy.end = 0;
+		copy.level = 0;
+		copy.join = NULL;
+
+		for (i = 0; i < context->chunks; ++i) {
+			copy.begin = i;
+			task_spawn(worker, &copy);
+		}
+	}
+}
+
+//  (, Ͱ) 󰴡ͰȡΡ˳ǰ׺ͣõڸͰедλã
+// ͬһͰȷǰļ¼ȶ
+void parallel_radix_prefix_task(Task_Worker* worker, const Task* task)
+{
+	Radix_Sort_Context* context = (Radix_Sort_Context*)task->context;
+	size_t sum = 0, count;
+	int i, d;
+
+	for (d = 0; d < PARALLEL_RADIX_BUCKETS; ++d) {
+		for (i = 0; i < context->chunks; ++i) {
+			count = context->counts[i * PARALLEL_RADIX_BUCKETS + d];
+			context->counts[i * PARALLEL_RADIX_BUCKETS + d] = sum;
+			sum += count;
+		}
+	}
+
+	parallel_radix_spawn_chunks(worker, context,
+		parallel_radix_scatter_task, parallel_radix_next_task);
+}
+
+void parallel_radix_start_task(Task_Worker* worker, const Task* task)
+{
+	Radix_Sort_Context* context = (Radix_Sort_Context*)task->context;
+
+	parallel_radix_spawn_chunks(worker, context,
+		parallel_radix_count_all_task, parallel_radix_plan_task);
+}
+
+bool parallel_radix_sort(int* array, size_t length, int threads)
+{
+	assert(array || length == 0);
+
+	if (length <= PARALLEL_RADIX_SORT_GRAIN) {
+		return radix_sort(array, length);
+	}
+
+	if (threads <= 0) {
+		threads = thread_hardware_concurrency();
+	}
+
+	Radix_Sort_Context* context = (Radix_Sort_Context*)malloc(sizeof(Radix_Sort_Context));
+	if (!context) {
+		return false;
+	}
+
+	context->array = (unsigned int*)array;
+	context->length = length;
+	context->chunks = threads;
+	context->temp = (unsigned int*)malloc(length * sizeof(unsigned int));
+	context->counts = (size_t*)malloc(
+		threads * PARALLEL_RADIX_PASSES * PARALLEL_RADIX_BUCKETS * sizeof(size_t));
+
+	if (!context->temp || !context->counts) {
+		free(context->temp);
+		free(context->counts);
+		free(context);
+		return false;
+	}
+
+	Task root;
+	root.func = parallel_radix_start_task;
+	root.context = context;
+	root.begin = root.end = 0;
+	root.level = 0;
+	root.join = NULL;
+
+	task_scheduler_run(threads, &root);
+
+	free(context->temp);
+	free(context->counts);
+	free(context);
+
+	return true;
+}
+
+
+//=========================================================
+//					м
+//=========================================================
+
+// ¼ڸֵʱֱӵôе counting_sort_auto
+#define PARALLEL_COUNTING_SORT_GRAIN	(1 << 16)
+
+struct Counting_Sort_Context {
+	int* array;
+	size_t length;
+	int chunks;
+	int* chunkMin;				// Сֵֵ
+	int* chunkMax;
+	int minValue;
+	size_t range;				// ֵ [minValue, minValue + range)
+	bool fallback;				// ֵ̫ڴ治㣬û
+	size_t* counts;				// [chunk][value]ֱͼ
+	size_t* starts;				// [value]ֵڽеʼλãstarts[range] == length
+	Task_Join join;
+};
+
+inline size_t counting_chunk_begin(size_t length, int chunks, int chunk)
+{
+	return length * chunk / chunks;
+}
+
+void parallel_counting_histogram_task(Task_Worker* worker, const Task* task);
+void parallel_counting_reduce_task(Task_Worker* worker, const Task* task);
+void parallel_counting_sum_task(Task_Worker* worker, const Task* task);
+void parallel_counting_prefix_task(Task_Worker* worker, const Task* task);
+void parallel_counting_fill_task(Task_Worker* worker, const Task* task);
+
+// 󱾿Сֵֵ
+void parallel_counting_min_max_task(Task_Worker* /* worker */, const Task* task)
+{
+	Counting_Sort_Context* context = (Counting_Sort_Context*)task->context;
+	int chunk = (int)task->begin;
+	size_t begin = counting_chunk_begin(context->length, context->chunks, chunk);
+	size_t end = counting_chunk_begin(context->length, context->chunks, chunk + 1);
+
+	simd_min_max(context->array + begin, end - begin,
+		&context->chunkMin[chunk], &context->chunkMax[chunk]);
+}
+
+// ֵ򣬾ܷ򣬷ֱͼ
+void parallel_counting_plan_task(Task_Worker* worker, const Task* task)
+{
+	Counting_Sort_Context* context = (Counting_Sort_Context*)task->context;
+	int minValue = context->chunkMin[0];
+	int maxValue = context->chunkMax[0];
+	int i;
+
+	for (i = 1; i < context->chunks; ++i) {
+		if (context->chunkMin[i] < minValue) {
+			minValue = context->chunkMin[i];
+		}
+		if (context->chunkMax[i] > maxValue) {
+			maxValue = context->chunkMax[i];
+		}
+	}
+
+	unsigned long long range = (unsigned long long)((long long)maxValue - minValue) + 1;
+
+	// ÿ߳һֱͼҲҪԤ֮
+	if (!counting_sort_range_fits(range * context->chunks, context->length)) {
+		context->fallback = true;
+		return;
+	}
+
+	context->minValue = minValue;
+	context->range = (size_t)range;
+	context->counts = (size_t*)calloc(context->chunks * context->range, sizeof(size_t));
+	context->starts = (size_t*)malloc((context->range + 1) * sizeof(size_t));
+	if (!context->counts || !context->starts) {
+		context->fallback = true;
+		return;
+	}
+
+	parallel_spawn_chunks(worker, context, &context->join, context->chunks,
+		parallel_counting_histogram_task, parallel_counting_reduce_task);
+}
+
+// ͳƱֱͼ߳дԼֱͼ
+void parallel_counting_histogram_task(Task_Worker* /* worker */, const Task* task)
+{
+	Counting_Sort_Context* context = (Counting_Sort_Context*)task->context;
+	int chunk = (int)task->begin;
+	size_t begin = counting_chunk_begin(context->length, context->chunks, chunk);
+	size_t end = counting_chunk_begin(context->length, context->chunks, chunk + 1);
+
+	counting_histogram(context->array + begin, end - begin, context->minValue,
+		context->range, context->counts + chunk * context->range);
+}
+
+// ֱͼͳɣֵֿ鲢л
+void parallel_counting_reduce_task(Task_Worker* worker, const Task* task)
+{
+	Counting_Sort_Context* context = (Counting_Sort_Context*)task->context;
+
+	parallel_spawn_chunks(worker, context, &context->join, context->chunks,
+		parallel_counting_sum_task, parallel_counting_prefix_task);
+}
+
+// ֵе chunk εļstarts[v] =  counts[v] ֮
+void parallel_counting_sum_task(Task_Worker* /* worker */, const Task* task)
+{
+	Counting_Sort_Context* context = (Counting_Sort_Context*)task->context;
+	int chunk = (int)task->begin;
+	size_t begin = counting_chunk_begin(context->range, context->chunks, chunk);
+	size_t end = counting_chunk_begin(context->range, context->chunks, chunk + 1);
+	size_t v, sum;
+	int i;
+
+	for (v = begin; v < end; ++v) {
+		sum = 0;
+		for (i = 0; i < context->chunks; ++i) {
+			sum += context->counts[i * context->range + v];
+		}
+		context->starts[v] = sum;
+	}
+}
+
+// ǰ׺ͣõֵʼλãȻλƽֿ鲢д
+void parallel_counting_prefix_task(Task_Worker* worker, const Task* task)
+{
+	Counting_Sort_Context* context = (Counting_Sort_Context*)task->context;
+	size_t sum = 0, count, v;
+
+	for (v = 0; v < context->range; ++v) {
+		count = context->starts[v];
+		context->starts[v] = sum;
+		sum += count;
+	}
+	context->starts[context->range] = sum;
+
+	Task fill;
+	int i;
+
+	fill.func = parallel_counting_fill_task;
+	fill.context = context;
+	fill.end = 0;
+	fill.level = 0;
+	fill.join = NULL;
+
+	for (i = 0; i < context->chunks; ++i) {
+		fill.begin = i;
+		task_spawn(worker, &fill);
+	}
+}
+
+// д [begin, end) һΣֲҵһֵٰд
+// ߳дλûص¼ĸ޹ء
+void parallel_counting_fill_task(Task_Worker* /* worker */, const Task* task)
+{
+	Counting_Sort_Context* context = (Counting_Sort_Context*)task->context;
+	int chunk = (int)task->begin;
+	size_t begin = counting_chunk_begin(context->length, context->chunks, chunk);
+	size_t end = counting_chunk_begin(context->length, context->chunks, chunk + 1);
+	const size_t* starts = context->starts;
+	size_t low = 0, high = context->range, mid, stop;
+	int value;
+
+	if (begin == end) {
+		return;
+	}
+
+	// һ starts[v] <= begin  v
+	while (high - low > 1) {
+		mid = low + (high - low) / 2;
+		if (starts[mid] <= begin) {
+			low = mid;
+		}
+		else {
+			high = mid;
+		}
+	}
+
+	value = (int)(context->minValue + (long long)low);
+
+	while (begin < end) {
+		stop = starts[low + 1] < end ? starts[low + 1] : end;
+
+		for (; begin < stop; ++begin) {
+			context->array[begin] = value;
+		}
+
+		++low;
+		++value;
+	}
+}
+
+void parallel_counting_start_task(Task_Worker* worker, const Task* task)
+{
+	Counting_Sort_Context* context = (Counting_Sort_Context*)task->context;
+
+	parallel_spawn_chunks(worker, context, &context->join, context->chunks,
+		parallel_counting_min_max_task, parallel_counting_plan_task);
+}
+
+bool parallel_counting_sort(int* array, size_t length, int threads)
+{
+	assert(array || length == 0);
+
+	if (length <= PARALLEL_COUNTING_SORT_GRAIN) {
+		return counting_sort_auto(array, (int)length);
+	}
+
+	if (threads <= 0) {
+		threads = thread_hardware_concurrency();
+	}
+
+	Counting_Sort_Context* context = (Counting_Sort_Context*)calloc(1, sizeof(Counting_Sort_Context));
+	if (!context) {
+		return false;
+	}
+
+	context->array = array;
+	context->length = length;
+	context->chunks = threads;
+	context->chunkMin = (int*)malloc(threads * sizeof(int));
+	context->chunkMax = (int*)malloc(threads * sizeof(int));
+
+	bool ok = context->chunkMin && context->chunkMax;
+
+	if (ok) {
+		Task root;
+		root.func = parallel_counting_start_task;
+		root.context = context;
+		root.begin = root.end = 0;
+		root.level = 0;
+		root.join = NULL;
+
+		task_scheduler_run(threads, &root);
+
+		// ֱͼ֮ǰѾˣʱ array ûбĶ
+		if (context->fallback) {
+			ok = parallel_radix_sort(array, length, threads);
+		}
+	}
+
+	free(context->chunkMin);
+	free(context->chunkMax);
+	free(context->counts);
+	free(context->starts);
+	free(context);
+
+	return ok;
+}
+
+
+//=========================================================
+//					
+//=========================================================
+
+// ¼ڸֵʱֱӵôе sample_sort
+#define PARALLEL_SAMPLE_SORT_GRAIN		(1 << 16)
+
+// 㻮ֵķͰĶ sample_sort ͬ
+#define PARALLEL_SAMPLE_SORT_LOG_BUCKETS	7
+
+#define PARALLEL_SAMPLE_SORT_MAX_BUCKETS	(2 << PARALLEL_SAMPLE_SORT_LOG_BUCKETS)
+
+struct Sample_Sort_Context {
+	int* array;
+	int* temp;
+	unsigned char* oracle;
+	size_t length;
+	int chunks;
+	int tree[1 << PARALLEL_SAMPLE_SORT_LOG_BUCKETS];
+	int splitters[1 << PARALLEL_SAMPLE_SORT_LOG_BUCKETS];
+	int logBuckets;
+	bool equal;
+	int buckets;						// ͰͰ
+	size_t* counts;						// [chunk][bucket]Ͱǰ׺֮Ϊдλ
+	size_t starts[PARALLEL_SAMPLE_SORT_MAX_BUCKETS + 1];	// Ͱڽеʼλ
+	int* ranges;						//  i ̸߳Ͱ [ranges[i], ranges[i + 1])
+	Task_Join join;
+};
+
+void parallel_sample_prefix_task(Task_Worker* worker, const Task* task);
+void parallel_sample_scatter_task(Task_Worker* worker, const Task* task);
+void parallel_sample_sort_buckets_task(Task_Worker* worker, const Task* task);
+
+inline bool sample_sort_is_equal_bucket(const Sample_Sort_Context* context, int bucket)
+{
+	return context->equal && (bucket & 1);
+}
+
+// Ա࣬ͳƸͰ
+void parallel_sample_classify_task(Task_Worker* /* worker */, const Task* task)
+{
+	Sample_Sort_Context* context = (Sample_Sort_Context*)task->context;
+	int chunk = (int)task->begin;
+	size_t begin = counting_chunk_begin(context->length, context->chunks, chunk);
+	size_t end = counting_chunk_begin(context->length, context->chunks, chunk + 1);
+	size_t* counts = context->counts + chunk * context->buckets;
+
+	memset(counts, 0, context->buckets * sizeof(size_t));
+
+	sample_sort_classify(context->array + begin, end - begin, context->tree, context->splitters,
+		context->logBuckets, context->equal, context->oracle + begin, counts);
+}
+
+// ڸͰедλãͰطָ߳
+void parallel_sample_prefix_task(Task_Worker* worker, const Task* task)
+{
+	Sample_Sort_Context* context = (Sample_Sort_Context*)task->context;
+	size_t sum = 0, count, size, work, total, done;
+	int i, b, range;
+
+	for (b = 0; b < context->buckets; ++b) {
+		context->starts[b] = sum;
+		for (i = 0; i < context->chunks; ++i) {
+			count = context->counts[i * context->buckets + b];
+			context->counts[i * context->buckets + b] = sum;
+			sum += count;
+		}
+	}
+	context->starts[context->buckets] = sum;
+
+	// Ͱֻ踴ƣ 1/8 빤
+	total = 0;
+	for (b = 0; b < context->buckets; ++b) {
+		size = context->starts[b + 1] - context->starts[b];
+		total += sample_sort_is_equal_bucket(context, b) ? size / 8 : size;
+	}
+
+	context->ranges[0] = 0;
+	range = 1;
+	done = 0;
+	for (b = 0; b < context->buckets && range < context->chunks; ++b) {
+		size = context->starts[b + 1] - context->starts[b];
+		work = sample_sort_is_equal_bucket(context, b) ? size / 8 : size;
+		done += work;
+
+		// ۼƹﵽ range ̵߳ķݶʱͰ֮п
+		while (range < context->chunks && done * context->chunks >= total * range) {
+			context->ranges[range++] = b + 1;
+		}
+	}
+	while (range <= context->chunks) {
+		context->ranges[range++] = context->buckets;
+	}
+
+	parallel_spawn_chunks(worker, context, &context->join, context->chunks,
+		parallel_sample_scatter_task, parallel_sample_sort_buckets_task);
+}
+
+// ѱļ¼䵽 temp иͰ
+void parallel_sample_scatter_task(Task_Worker* /* worker */, const Task* task)
+{
+	Sample_Sort_Context* context = (Sample_Sort_Context*)task->context;
+	int chunk = (int)task->begin;
+	size_t begin = counting_chunk_begin(context->length, context->chunks, chunk);
+	size_t end = counting_chunk_begin(context->length, context->chunks, chunk + 1);
+	size_t* offsets = context->counts + chunk * context->buckets;
+	const int* array = context->array;
+	const unsigned char* oracle = context->oracle;
+	int* temp = context->temp;
+	size_t i;
+
+	for (i = begin; i < end; ++i) {
+		temp[offsets[oracle[i]]++] = array[i];
+	}
+}
+
+// ߳ԼͰд array
+void parallel_sample_bucket_range_task(Task_Worker* /* worker */, const Task* task)
+{
+	Sample_Sort_Context* context = (Sample_Sort_Context*)task->context;
+	int range = (int)task->begin;
+	size_t begin, size;
+	int b;
+
+	for (b = context->ranges[range]; b < context->ranges[range + 1]; ++b) {
+		begin = context->starts[b];
+		size = context->starts[b + 1] - begin;
+
+		memcpy(context->array + begin, context->temp + begin, size * sizeof(int));
+
+		if (size > 1 && !sample_sort_is_equal_bucket(context, b)) {
+			sample_sort_impl(context->array + begin, context->temp + begin,
+				context->oracle + begin, size);
+		}
+	}
+}
+
+void parallel_sample_sort_buckets_task(Task_Worker* worker, const Task* task)
+{
+	Sample_Sort_Context* context = (Sample_Sort_Context*)task->context;
+	Task sort;
+	int i;
+
+	sort.func = parallel_sample_bucket_range_task;
+	sort.context = context;
+	sort.end = 0;
+	sort.level = 0;
+	sort.join = NULL;
+
+	for (i = 0; i < context->chunks; ++i) {
+		sort.begin = i;
+		task_spawn(worker, &sort);
+	}
+}
+
+void parallel_sample_start_task(Task_Worker* worker, const Task* task)
+{
+	Sample_Sort_Context* context = (Sample_Sort_Context*)task->context;
+
+	parallel_spawn_chunks(worker, context, &context->join, context->chunks,
+		parallel_sample_classify_task, parallel_sample_prefix_task);
+}
+
+bool parallel_sample_sort(int* array, size_t length, int threads)
+{
+	assert(array || length == 0);
+
+	if (length <= PARALLEL_SAMPLE_SORT_GRAIN) {
+		return sample_sort(array, (int)length);
+	}
+
+	if (threads <= 0) {
+		threads = thread_hardware_concurrency();
+	}
+
+	Sample_Sort_Context* context = (Sample_Sort_Context*)calloc(1, sizeof(Sample_Sort_Context));
+	if (!context) {
+		return false;
+	}
+
+	context->array = array;
+	context->length = length;
+	context->chunks = threads;
+	context->temp = (int*)malloc(length * sizeof(int));
+	context->oracle = (unsigned char*)malloc(length);
+	context->counts = (size_t*)malloc(threads * PARALLEL_SAMPLE_SORT_MAX_BUCKETS * sizeof(size_t));
+	context->ranges = (int*)malloc((threads + 1) * sizeof(int));
+
+	bool ok = context->temp && context->oracle && context->counts && context->ranges;
+
+	if (ok) {
+		// ָԪֻڵ߳
+		context->logBuckets = sample_sort_build_splitters(array, length,
+			PARALLEL_SAMPLE_SORT_LOG_BUCKETS, context->tree, context->splitters, &context->equal);
+		context->buckets = (1 << context->logBuckets) * (context->equal ? 2 : 1);
+
+		Task root;
+		root.func = parallel_sample_start_task;
+		root.context = context;
+		root.begin = root.end = 0;
+		root.level = 0;
+		root.join = NULL;
+
+		task_scheduler_run(threads, &root);
+	}
+
+	free(context->temp);
+	free(context->oracle);
+	free(context->counts);
+	free(context->ranges);
+	free(context);
+
+	return ok;
+}
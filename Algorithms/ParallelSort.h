@@ -0,0 +1,94 @@
+#ifndef __PARALLEL_SORT_H__
+#define __PARALLEL_SORT_H__
+
+#include <stddef.h>
+
+#include "SortAlgorithms.h"
+
+/**
+* 㷨	 п
+* 㷨	 ڹȡִпÿλ֮Ϊ
+*             ȥɿ߳ȡִС
+*             ܴ󣬴лֻΪƿΪл֣
+*             ֿ飬̶߳ԼĿ֣ɸ̲߳нλļ¼
+*             Сʱֱӵôе quick_sort
+* ʱ临Ӷ ƽO(nlgn / p)p Ϊ߳
+* ռ临Ӷ O(lgn)
+* ȶ	 
+* 		 threads Ϊ߳<= 0 ʱʹȫ
+*/
+void parallel_quick_sort(int* array, size_t length, int threads);
+
+// ָвֵĻַ quick_sort_ex
+void parallel_quick_sort_ex(int* array, size_t length, int threads,
+	Quick_Partition_Scheme scheme);
+
+
+/**
+* 㷨	 й鲢
+* 㷨	 Ϊ array һ֮佻鲢
+*             鲢ʱ merge pathco-rankֲҰƽ
+*             ֳɶΣÿ̶߳鲢һΣ̹ܵ߳鲢ơ
+*             ȵļ¼ȡǰһеģȶġ
+* ʱ临Ӷ O(nlgn / p)p Ϊ߳
+* ռ临Ӷ O(n)
+* ȶ	 
+* 		 threads Ϊ߳<= 0 ʱʹȫ
+* ֵ	 ʧʱ falseʱ array ֲ
+*/
+bool parallel_merge_sort(int* array, size_t length, int threads);
+
+
+/**
+* 㷨	 л
+* 㷨	 LSD ÿ 8 λΪһݷֳ߳ͬĿ飺
+*             1) ߳ͳԼеͰ
+*             2)  (, Ͱ) ǰ׺ͣõÿÿͰедλã
+*             3) ̰߳Լеļ¼ȥдÿͰдϲ
+*                ܹ 16 ¼64 ֽڣһдɢд֮߳
+*                Իеáдλûаж룬һοܿС
+*             һζʱͳзм¼ͬķ
+* ʱ临Ӷ O(n / p)p Ϊ߳
+* ռ临Ӷ O(n)
+* ȶ	 
+* 		 threads Ϊ߳<= 0 ʱʹȫ
+* ֵ	 ռʧʱ falseʱ array ֲ
+*/
+bool parallel_radix_sort(int* array, size_t length, int threads);
+
+
+/**
+* 㷨	 м
+* 㷨	 ݷֳ߳ͬĿ飺
+*             1) ߳ simd_min_max ԼСֵֵܵõֵ
+*             2) ߳ͳԼֱͼֵֶٰβлܡǰ׺ͣ
+*             3) λƽֶΣ̶ֲ߳Լεĵһֵд
+*             ÿ߳һֱͼԤ㣨ڼ¼Ҵ 16K
+*             ʱ parallel_radix_sort
+* ʱ临Ӷ O(n / p + m)p Ϊ߳m ΪֵС
+* ռ临Ӷ O(p * m)
+* ȶ	 ǣint ȵļ¼޷֣
+* 		 threads Ϊ߳<= 0 ʱʹȫ
+* ֵ	 ռʧʱ falseʱ array ֲ
+*/
+bool parallel_counting_sort(int* array, size_t length, int threads);
+
+
+/**
+* 㷨	 
+* 㷨	 ѡ 127 ָԪأظʱͰݷֳ߳
+*             ͬĿ飺
+*             1) ߳÷ָԪԼĿಢͳͰ
+*             2)  (, Ͱ) ǰ׺̰ͣ߳Լļ¼䵽Ͱ
+*             3) ɸͰָһ̣߳߳ sample_sort
+*                ԼͰͰֻ踴ƣZipf ֲȵؼֲ
+*                ĳ̸߳ء
+* ʱ临Ӷ O(nlgn / p)p Ϊ߳
+* ռ临Ӷ O(n)
+* ȶ	 
+* 		 threads Ϊ߳<= 0 ʱʹȫ
+* ֵ	 ռʧʱ falseʱ array ֲ
+*/
+bool parallel_sample_sort(int* array, size_t length, int threads);
+
+#endif // __PARALLEL_SORT_H__
@@ -0,0 +1,490 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <memory.h>
+#include <assert.h>
+
+#include "SimdSort.h"
+#include "SetOperations.h"
+
+#if SIMD_AVX2_SUPPORTED
+#include <immintrin.h>
+#endif
+
+// ϵĴСʱ󽻡ָ
+#define SET_GALLOP_RATIO		32
+
+// 8 λ 1 ĸ
+inline unsigned int set_bit_count(unsigned int mask)
+{
+	mask = mask - ((mask >> 1) & 0x55);
+	mask = (mask & 0x33) + ((mask >> 2) & 0x33);
+	return (mask + (mask >> 4)) & 0x0F;
+}
+
+//  start ʼ array[0, length) вҵһС key λã
+//  1, 2, 4, ... Ĳ̽һжֲ
+size_t set_gallop(const int* array, size_t length, size_t start, int key)
+{
+	size_t low = start;
+	size_t high = start + 1;
+	size_t step = 1;
+	size_t mid;
+
+	if (start >= length || array[start] >= key) {
+		return start;
+	}
+
+	// array[low] < key
+	while (high < length && array[high] < key) {
+		low = high;
+		step <<= 1;
+		high = low + step;
+	}
+
+	if (high > length) {
+		high = length;
+	}
+
+	//  (low, high] 
+	while (high - low > 1) {
+		mid = low + (high - low) / 2;
+		if (array[mid] < key) {
+			low = mid;
+		}
+		else {
+			high = mid;
+		}
+	}
+
+	return high;
+}
+
+
+//=========================================================
+//					SIMD д
+//=========================================================
+
+#if SIMD_AVX2_SUPPORTED
+
+// 8 λ m Ӧû t  4 λΪ m е t  1 ڵλã
+//  permutevar8x32 Ϊ 1 ļ¼Ƶǰ
+static const unsigned int set_compress_avx2[256] = {
+	0x00000000, 0x00000000, 0x00000001, 0x00000010, 0x00000002, 0x00000020, 0x00000021, 0x00000210,
+	0x00000003, 0x00000030, 0x00000031, 0x00000310, 0x00000032, 0x00000320, 0x00000321, 0x00003210,
+	0x00000004, 0x00000040, 0x00000041, 0x00000410, 0x00000042, 0x00000420, 0x00000421, 0x00004210,
+	0x00000043, 0x00000430, 0x00000431, 0x00004310, 0x00000432, 0x00004320, 0x00004321, 0x00043210,
+	0x00000005, 0x00000050, 0x00000051, 0x00000510, 0x00000052, 0x00000520, 0x00000521, 0x00005210,
+	0x00000053, 0x00000530, 0x00000531, 0x00005310, 0x00000532, 0x00005320, 0x00005321, 0x00053210,
+	0x00000054, 0x00000540, 0x00000541, 0x00005410, 0x00000542, 0x00005420, 0x00005421, 0x00054210,
+	0x00000543, 0x00005430, 0x00005431, 0x00054310, 0x00005432, 0x00054320, 0x00054321, 0x00543210,
+	0x00000006, 0x00000060, 0x00000061, 0x00000610, 0x00000062, 0x00000620, 0x00000621, 0x00006210,
+	0x00000063, 0x00000630, 0x00000631, 0x00006310, 0x00000632, 0x00006320, 0x00006321, 0x00063210,
+	0x00000064, 0x00000640, 0x00000641, 0x00006410, 0x00000642, 0x00006420, 0x00006421, 0x00064210,
+	0x00000643, 0x00006430, 0x00006431, 0x00064310, 0x00006432, 0x00064320, 0x00064321, 0x00643210,
+	0x00000065, 0x00000650, 0x00000651, 0x00006510, 0x00000652, 0x00006520, 0x00006521, 0x00065210,
+	0x00000653, 0x00006530, 0x00006531, 0x00065310, 0x00006532, 0x00065320, 0x00065321, 0x00653210,
+	0x00000654, 0x00006540, 0x00006541, 0x00065410, 0x00006542, 0x00065420, 0x00065421, 0x00654210,
+	0x00006543, 0x00065430, 0x00065431, 0x00654310, 0x00065432, 0x00654320, 0x00654321, 0x06543210,
+	0x00000007, 0x00000070, 0x00000071, 0x00000710, 0x00000072, 0x00000720, 0x00000721, 0x00007210,
+	0x00000073, 0x00000730, 0x00000731, 0x00007310, 0x00000732, 0x00007320, 0x00007321, 0x00073210,
+	0x00000074, 0x00000740, 0x00000741, 0x00007410, 0x00000742, 0x00007420, 0x00007421, 0x00074210,
+	0x00000743, 0x00007430, 0x00007431, 0x00074310, 0x00007432, 0x00074320, 0x00074321, 0x00743210,
+	0x00000075, 0x00000750, 0x00000751, 0x00007510, 0x00000752, 0x00007520, 0x00007521, 0x00075210,
+	0x00000753, 0x00007530, 0x00007531, 0x00075310, 0x00007532, 0x00075320, 0x00075321, 0x00753210,
+	0x00000754, 0x00007540, 0x00007541, 0x00075410, 0x00007542, 0x00075420, 0x00075421, 0x00754210,
+	0x00007543, 0x00075430, 0x00075431, 0x00754310, 0x00075432, 0x00754320, 0x00754321, 0x07543210,
+	0x00000076, 0x00000760, 0x00000761, 0x00007610, 0x00000762, 0x00007620, 0x00007621, 0x00076210,
+	0x00000763, 0x00007630, 0x00007631, 0x00076310, 0x00007632, 0x00076320, 0x00076321, 0x00763210,
+	0x00000764, 0x00007640, 0x00007641, 0x00076410, 0x00007642, 0x00076420, 0x00076421, 0x00764210,
+	0x00007643, 0x00076430, 0x00076431, 0x00764310, 0x00076432, 0x00764320, 0x00764321, 0x07643210,
+	0x00000765, 0x00007650, 0x00007651, 0x00076510, 0x00007652, 0x00076520, 0x00076521, 0x00765210,
+	0x00007653, 0x00076530, 0x00076531, 0x00765310, 0x00076532, 0x00765320, 0x00765321, 0x07653210,
+	0x00007654, 0x00076540, 0x00076541, 0x00765410, 0x00076542, 0x00765420, 0x00765421, 0x07654210,
+	0x00076543, 0x00765430, 0x00765431, 0x07654310, 0x00765432, 0x07654320, 0x07654321, 0x76543210
+};
+
+// 4 λӦ pshufb ֽû0x80 ʾд 0
+static const unsigned char set_compress_sse[16][16] = {
+	{0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+	{0, 1, 2, 3, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+	{4, 5, 6, 7, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+	{0, 1, 2, 3, 4, 5, 6, 7, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+	{8, 9, 10, 11, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+	{0, 1, 2, 3, 8, 9, 10, 11, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+	{4, 5, 6, 7, 8, 9, 10, 11, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+	{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 0x80, 0x80, 0x80, 0x80},
+	{12, 13, 14, 15, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+	{0, 1, 2, 3, 12, 13, 14, 15, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+	{4, 5, 6, 7, 12, 13, 14, 15, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+	{0, 1, 2, 3, 4, 5, 6, 7, 12, 13, 14, 15, 0x80, 0x80, 0x80, 0x80},
+	{8, 9, 10, 11, 12, 13, 14, 15, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+	{0, 1, 2, 3, 8, 9, 10, 11, 12, 13, 14, 15, 0x80, 0x80, 0x80, 0x80},
+	{4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 0x80, 0x80, 0x80, 0x80},
+	{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15}
+};
+
+//  v Ϊ 1 ļ¼д outд 8 
+SIMD_TARGET_AVX2 inline void set_compress_store_avx2(int* out, __m256i v, unsigned int mask)
+{
+	const __m256i shifts = _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28);
+	__m256i index = _mm256_srlv_epi32(_mm256_set1_epi32((int)set_compress_avx2[mask]), shifts);
+
+	index = _mm256_and_si256(index, _mm256_set1_epi32(7));
+	_mm256_storeu_si256((__m256i*)out, _mm256_permutevar8x32_epi32(v, index));
+}
+
+#endif
+
+
+//=========================================================
+//					ȥ
+//=========================================================
+
+#if SIMD_AVX2_SUPPORTED
+
+// ÿδ 8 ¼Եǰһ¼Ƚϣȵġ
+// дλòλãд 8 ʱܸѶļ¼
+// һǰһ¼ last дǰȶ
+SIMD_TARGET_AVX2 size_t sorted_unique_avx2(int* array, size_t length, size_t* position)
+{
+	const __m256i shiftRight = _mm256_setr_epi32(0, 0, 1, 2, 3, 4, 5, 6);
+	__m256i current, previous;
+	unsigned int mask;
+	size_t i = 1;
+	size_t k = 1;
+	int last = array[0];
+	int next;
+
+	while (i + 8 <= length) {
+		current = _mm256_loadu_si256((const __m256i*)(array + i));
+		previous = _mm256_blend_epi32(_mm256_permutevar8x32_epi32(current, shiftRight),
+			_mm256_set1_epi32(last), 0x01);
+		next = array[i + 7];
+
+		mask = ~(unsigned int)_mm256_movemask_ps(_mm256_castsi256_ps(
+			_mm256_cmpeq_epi32(current, previous))) & 0xFF;
+		set_compress_store_avx2(array + k, current, mask);
+
+		k += set_bit_count(mask);
+		i += 8;
+		last = next;
+	}
+
+	*position = i;
+	return k;
+}
+
+#endif
+
+size_t sorted_unique(int* array, size_t length)
+{
+	assert(array || length == 0);
+
+	size_t i = 1;
+	size_t k = 1;
+	int value;
+	bool keep;
+
+	if (length < 2) {
+		return length;
+	}
+
+#if SIMD_AVX2_SUPPORTED
+	if (cpu_has_avx2()) {
+		k = sorted_unique_avx2(array, length, &i);
+	}
+#endif
+
+	// [0, k) ȥأļ¼Ƚ
+	for (; i < length; ++i) {
+		value = array[i];
+		keep = (value != array[k - 1]);
+		array[k] = value;
+		k += keep;
+	}
+
+	return k;
+}
+
+
+//=========================================================
+//					
+//=========================================================
+
+//  a[i]b[j] ʼȽϣд out + kµ k
+size_t set_intersect_scalar(const int* a, size_t na, const int* b, size_t nb, int* out,
+	size_t i, size_t j, size_t k)
+{
+	int x, y;
+
+	while (i < na && j < nb) {
+		x = a[i];
+		y = b[j];
+		out[k] = x;
+		k += (x == y);
+		i += (x <= y);
+		j += (y <= x);
+	}
+
+	return k;
+}
+
+#if SIMD_AVX2_SUPPORTED
+
+// 4  4b ļĴת 3 Σ a ļĴλȽ
+SIMD_TARGET_SSSE3 size_t set_intersect_sse(const int* a, size_t na, const int* b, size_t nb,
+	int* out, size_t* pi, size_t* pj)
+{
+	size_t capacity = (na < nb) ? na : nb;
+	size_t i = 0;
+	size_t j = 0;
+	size_t k = 0;
+	__m128i va, vb, equal;
+	unsigned int mask;
+	int amax, bmax;
+
+	// ÿд 4 ʣʱȽ
+	while (i + 4 <= na && j + 4 <= nb && k + 4 <= capacity) {
+		va = _mm_loadu_si128((const __m128i*)(a + i));
+		vb = _mm_loadu_si128((const __m128i*)(b + j));
+
+		equal = _mm_cmpeq_epi32(va, vb);
+		equal = _mm_or_si128(equal, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1))));
+		equal = _mm_or_si128(equal, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))));
+		equal = _mm_or_si128(equal, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3))));
+
+		mask = (unsigned int)_mm_movemask_ps(_mm_castsi128_ps(equal));
+		_mm_storeu_si128((__m128i*)(out + k), _mm_shuffle_epi8(va,
+			_mm_loadu_si128((const __m128i*)set_compress_sse[mask])));
+		k += set_bit_count(mask);
+
+		// ĩβСһѱȽ꣬ǰʱ඼ǰ
+		amax = a[i + 3];
+		bmax = b[j + 3];
+		i += (amax <= bmax) ? 4 : 0;
+		j += (bmax <= amax) ? 4 : 0;
+	}
+
+	*pi = i;
+	*pj = j;
+	return k;
+}
+
+// 8  8b ļĴת 7 
+SIMD_TARGET_AVX2 size_t set_intersect_avx2(const int* a, size_t na, const int* b, size_t nb,
+	int* out, size_t* pi, size_t* pj)
+{
+	const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+	size_t capacity = (na < nb) ? na : nb;
+	size_t i = 0;
+	size_t j = 0;
+	size_t k = 0;
+	__m256i va, vb, equal;
+	unsigned int mask;
+	int amax, bmax, r;
+
+	while (i + 8 <= na && j + 8 <= nb && k + 8 <= capacity) {
+		va = _mm256_loadu_si256((const __m256i*)(a + i));
+		vb = _mm256_loadu_si256((const __m256i*)(b + j));
+
+		equal = _mm256_cmpeq_epi32(va, vb);
+		for (r = 1; r < 8; ++r) {
+			vb = _mm256_permutevar8x32_epi32(vb, rotate);
+			equal = _mm256_or_si256(equal, _mm256_cmpeq_epi32(va, vb));
+		}
+
+		mask = (unsigned int)_mm256_movemask_ps(_mm256_castsi256_ps(equal));
+		set_compress_store_avx2(out + k, va, mask);
+		k += set_bit_count(mask);
+
+		amax = a[i + 7];
+		bmax = b[j + 7];
+		i += (amax <= bmax) ? 8 : 0;
+		j += (bmax <= amax) ? 8 : 0;
+	}
+
+	*pi = i;
+	*pj = j;
+	return k;
+}
+
+#endif
+
+// С a ÿ¼ڽϴ󼯺 b ָ
+size_t set_intersect_gallop(const int* a, size_t na, const int* b, size_t nb, int* out)
+{
+	size_t j = 0;
+	size_t k = 0;
+
+	for (size_t i = 0; i < na; ++i) {
+		j = set_gallop(b, nb, j, a[i]);
+		if (j == nb) {
+			break;
+		}
+
+		if (b[j] == a[i]) {
+			out[k++] = a[i];
+			++j;
+		}
+	}
+
+	return k;
+}
+
+size_t set_intersect_ex(const int* a, size_t na, const int* b, size_t nb, int* out,
+	Set_Intersect_Kernel kernel)
+{
+	assert((a || na == 0) && (b || nb == 0) && (out || na == 0 || nb == 0));
+
+	size_t i = 0;
+	size_t j = 0;
+	size_t k = 0;
+
+	if (kernel == SET_INTERSECT_AUTO) {
+		if (na > SET_GALLOP_RATIO * nb || nb > SET_GALLOP_RATIO * na) {
+			kernel = SET_INTERSECT_GALLOP;
+		}
+		else {
+			kernel = cpu_has_avx2() ? SET_INTERSECT_AVX2 : SET_INTERSECT_SSE;
+		}
+	}
+
+	switch (kernel) {
+	case SET_INTERSECT_GALLOP:
+		return (na <= nb) ? set_intersect_gallop(a, na, b, nb, out)
+			: set_intersect_gallop(b, nb, a, na, out);
+
+#if SIMD_AVX2_SUPPORTED
+	case SET_INTERSECT_AVX2:
+		if (cpu_has_avx2()) {
+			k = set_intersect_avx2(a, na, b, nb, out, &i, &j);
+		}
+		break;
+
+	case SET_INTERSECT_SSE:
+		if (cpu_has_ssse3()) {
+			k = set_intersect_sse(a, na, b, nb, out, &i, &j);
+		}
+		break;
+#endif
+
+	default:
+		break;
+	}
+
+	// һĴĲȽ
+	return set_intersect_scalar(a, na, b, nb, out, i, j, k);
+}
+
+size_t set_intersect(const int* a, size_t na, const int* b, size_t nb, int* out)
+{
+	return set_intersect_ex(a, na, b, nb, out, SET_INTERSECT_AUTO);
+}
+
+
+//=========================================================
+//					
+//=========================================================
+
+// С small ÿ¼ڽϴ󼯺 large ָ
+// мһֱӸơʱ඼еļ¼ֻдһ
+size_t set_union_gallop(const int* small, size_t ns, const int* large, size_t nl, int* out)
+{
+	size_t start = 0;
+	size_t pos;
+	size_t k = 0;
+
+	for (size_t i = 0; i < ns; ++i) {
+		pos = set_gallop(large, nl, start, small[i]);
+		memcpy(out + k, large + start, (pos - start) * sizeof(int));
+		k += pos - start;
+
+		out[k++] = small[i];
+		start = (pos < nl && large[pos] == small[i]) ? pos + 1 : pos;
+	}
+
+	memcpy(out + k, large + start, (nl - start) * sizeof(int));
+
+	return k + nl - start;
+}
+
+size_t set_union(const int* a, size_t na, const int* b, size_t nb, int* out)
+{
+	assert((a || na == 0) && (b || nb == 0) && (out || na + nb == 0));
+
+	size_t i = 0;
+	size_t j = 0;
+	size_t k = 0;
+	int x, y;
+
+	if (na > SET_GALLOP_RATIO * nb) {
+		return set_union_gallop(b, nb, a, na, out);
+	}
+
+	if (nb > SET_GALLOP_RATIO * na) {
+		return set_union_gallop(a, na, b, nb, out);
+	}
+
+	while (i < na && j < nb) {
+		x = a[i];
+		y = b[j];
+		out[k++] = (x < y) ? x : y;
+		i += (x <= y);
+		j += (y <= x);
+	}
+
+	memcpy(out + k, a + i, (na - i) * sizeof(int));
+	k += na - i;
+	memcpy(out + k, b + j, (nb - j) * sizeof(int));
+
+	return k + nb - j;
+}
+
+size_t set_difference(const int* a, size_t na, const int* b, size_t nb, int* out)
+{
+	assert((a || na == 0) && (b || nb == 0) && (out || na == 0));
+
+	size_t i = 0;
+	size_t j = 0;
+	size_t k = 0;
+	size_t pos;
+	int x, y;
+
+	// b С a ҵ b ÿ¼мһֱӸ
+	if (na > SET_GALLOP_RATIO * nb) {
+		for (j = 0; j < nb; ++j) {
+			pos = set_gallop(a, na, i, b[j]);
+			memcpy(out + k, a + i, (pos - i) * sizeof(int));
+			k += pos - i;
+			i = (pos < na && a[pos] == b[j]) ? pos + 1 : pos;
+		}
+
+		memcpy(out + k, a + i, (na - i) * sizeof(int));
+		return k + na - i;
+	}
+
+	// a С b в a ÿ¼
+	if (nb > SET_GALLOP_RATIO * na) {
+		for (i = 0; i < na; ++i) {
+			j = set_gallop(b, nb, j, a[i]);
+			if (j == nb || b[j] != a[i]) {
+				out[k++] = a[i];
+			}
+		}
+
+		return k;
+	}
+
+	while (i < na && j < nb) {
+		x = a[i];
+		y = b[j];
+		out[k] = x;
+		k += (x < y);
+		i += (x <= y);
+		j += (y <= x);
+	}
+
+	memcpy(out + k, a + i, (na - i) * sizeof(int));
+
+	return k + na - i;
+}
@@ -0,0 +1,50 @@
+#ifndef __SET_OPERATIONS_H__
+#define __SET_OPERATIONS_H__
+
+#include <stddef.h>
+
+/**
+* ϵļ㣺Ϊź飨 SortAlgorithms и
+* ÿϱϸûظļ¼ sorted_unique ȥأ
+* ͬϸļ¼ص
+*/
+
+// ԭɾ array[0, length) ظļ¼ʣµĸ
+// ֧ AVX2 ʱÿαȽڵ 8 Լ¼òõûһдظļ¼
+size_t sorted_unique(int* array, size_t length);
+
+// 󽻼ķ
+enum Set_Intersect_Kernel {
+	SET_INTERSECT_AUTO,		// ϴС 32 ʱ GALLOPֵ֧ SIMD 
+	SET_INTERSECT_SCALAR,	// ȽϵĹ鲢ǰһͣûз֧
+	SET_INTERSECT_SSE,		// ÿαȽ 4  4 ¼SSE2 ȽϣSSSE3 pshufb д
+	SET_INTERSECT_AVX2,		// ÿαȽ 8  8 ¼AVX2 Ƚû
+	SET_INTERSECT_GALLOP	// Сϵÿ¼ڽϴ󼯺ָ
+};
+
+/**
+* 㷨	 򼯺
+* 㷨	 SIMD Schlegel ȣÿθȡ 4  8 ¼һļĴ
+*             ת 3  7 ΣһλȽϣõȼ¼λ룬
+*             õЩ¼Ƶǰûһдĩβϴһ
+*             ǰһౣֲûԤķ֧
+*             ϴСܴʱСϵÿ¼һҵλ
+*             ϴ󼯺ָ1, 2, 4, ... һжֲҡ
+* ʱ临Ӷ SIMD ȽϣO(na + nb)ָO(m lg(n / m))m <= n
+* ռ临Ӷ O(1)
+* 		 out Ҫ min(na, nb) ¼
+* ֵ	 ļ¼
+*/
+size_t set_intersect(const int* a, size_t na, const int* b, size_t nb, int* out);
+
+// ָķ󽻼֧ʱȽ
+size_t set_intersect_ex(const int* a, size_t na, const int* b, size_t nb, int* out,
+	Set_Intersect_Kernel kernel);
+
+// out Ҫ na + nb ¼
+size_t set_union(const int* a, size_t na, const int* b, size_t nb, int* out);
+
+//  a - bout Ҫ na ¼
+size_t set_difference(const int* a, size_t na, const int* b, size_t nb, int* out);
+
+#endif // __SET_OPERATIONS_H__
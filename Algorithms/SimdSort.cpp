@@ -0,0 +1,478 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <limits.h>
+#include <assert.h>
+#include <memory.h>
+
+#include "SortAlgorithms.h"
+#include "SimdSort.h"
+
+#if SIMD_AVX2_SUPPORTED
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+bool cpu_has_avx2()
+{
+	static int result = -1;
+
+	if (result < 0) {
+#if !SIMD_AVX2_SUPPORTED
+		result = 0;
+#elif defined(_MSC_VER)
+		int info[4];
+		bool osxsave, avx2 = false;
+
+		// ֧ AVX2Ҳϵͳᱣ YMM Ĵ
+		__cpuid(info, 0);
+		if (info[0] >= 7) {
+			__cpuid(info, 1);
+			osxsave = (info[2] & (1 << 27)) != 0;
+
+			__cpuidex(info, 7, 0);
+			avx2 = osxsave && (info[1] & (1 << 5)) != 0
+				&& (_xgetbv(0) & 6) == 6;
+		}
+
+		result = avx2 ? 1 : 0;
+#else
+		__builtin_cpu_init();
+		result = __builtin_cpu_supports("avx2") ? 1 : 0;
+#endif
+	}
+
+	return result == 1;
+}
+
+bool cpu_has_ssse3()
+{
+	static int result = -1;
+
+	if (result < 0) {
+#if !SIMD_AVX2_SUPPORTED
+		result = 0;
+#elif defined(_MSC_VER)
+		int info[4];
+
+		__cpuid(info, 1);
+		result = (info[2] & (1 << 9)) ? 1 : 0;
+#else
+		__builtin_cpu_init();
+		result = __builtin_cpu_supports("ssse3") ? 1 : 0;
+#endif
+	}
+
+	return result == 1;
+}
+
+#if SIMD_AVX2_SUPPORTED
+
+// simd_merge ÿδļĴ¼
+#ifndef SIMD_MERGE_REGISTERS
+#define SIMD_MERGE_REGISTERS	2
+#endif
+#define SIMD_MERGE_BLOCK		(8 * SIMD_MERGE_REGISTERS)
+
+// һαȽϽÿһ· partner жӦһ·Ƚϣmask Ϊ 1 ·ȡϴֵ
+#define BITONIC_STEP(v, partner, mask)	\
+	_mm256_blend_epi32(_mm256_min_epi32(v, partner), _mm256_max_epi32(v, partner), mask)
+
+// Ĵ 1/2/4 ·Ԫؽλ
+SIMD_TARGET_AVX2 inline __m256i swap_lanes_1(__m256i v)
+{
+	return _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+}
+
+SIMD_TARGET_AVX2 inline __m256i swap_lanes_2(__m256i v)
+{
+	return _mm256_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+}
+
+SIMD_TARGET_AVX2 inline __m256i swap_lanes_4(__m256i v)
+{
+	return _mm256_permute2x128_si256(v, v, 1);
+}
+
+SIMD_TARGET_AVX2 inline __m256i reverse_lanes(__m256i v)
+{
+	return _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+}
+
+// Ĵе 8 Ԫع˫У鲢Ϊ
+SIMD_TARGET_AVX2 inline __m256i bitonic_merge_register(__m256i v)
+{
+	v = BITONIC_STEP(v, swap_lanes_4(v), 0xF0);
+	v = BITONIC_STEP(v, swap_lanes_2(v), 0xCC);
+	v = BITONIC_STEP(v, swap_lanes_1(v), 0xAA);
+
+	return v;
+}
+
+// ĴųΪ 24 Σһ 8 ·˫鲢
+SIMD_TARGET_AVX2 inline __m256i bitonic_sort_register(__m256i v)
+{
+	v = BITONIC_STEP(v, swap_lanes_1(v), 0x66);
+	v = BITONIC_STEP(v, swap_lanes_2(v), 0x3C);
+	v = BITONIC_STEP(v, swap_lanes_1(v), 0x5A);
+
+	return bitonic_merge_register(v);
+}
+
+// v[0, count) ιһ˫У鲢Ϊ
+SIMD_TARGET_AVX2 inline void bitonic_merge_registers(__m256i* v, int count)
+{
+	int i, d;
+	__m256i low, high;
+
+	// Ĵ֮䣺Ƚ d ĴԪ
+	for (d = count / 2; d > 0; d /= 2) {
+		for (i = 0; i < count; ++i) {
+			if ((i & d) == 0) {
+				low = _mm256_min_epi32(v[i], v[i + d]);
+				high = _mm256_max_epi32(v[i], v[i + d]);
+				v[i] = low;
+				v[i + d] = high;
+			}
+		}
+	}
+
+	// ÿĴ˫
+	for (i = 0; i < count; ++i) {
+		v[i] = bitonic_merge_register(v[i]);
+	}
+}
+
+// v[0, count) ǰ򣬹鲢Ϊ
+// ǰһĵ k Ԫһĵ k ԪرȽϣСɵǰһ
+// ϴɵĺһ붼˫Уǰһ붼ںһ롣
+SIMD_TARGET_AVX2 inline void bitonic_merge_sorted_halves(__m256i* v, int count)
+{
+	int i;
+	int half = count / 2;
+	__m256i low[SMALL_SORT_MAX / 16], high[SMALL_SORT_MAX / 16];
+	__m256i reversed;
+
+	for (i = 0; i < half; ++i) {
+		reversed = reverse_lanes(v[count - 1 - i]);
+		low[i] = _mm256_min_epi32(v[i], reversed);
+		high[i] = _mm256_max_epi32(v[i], reversed);
+	}
+
+	for (i = 0; i < half; ++i) {
+		v[i] = low[i];
+		v[half + i] = high[i];
+	}
+
+	bitonic_merge_registers(v, half);
+	bitonic_merge_registers(v + half, half);
+}
+
+//  count124  8Ĵе 8 * count Ԫ
+SIMD_TARGET_AVX2 void bitonic_sort_registers(__m256i* v, int count)
+{
+	if (count == 1) {
+		v[0] = bitonic_sort_register(v[0]);
+		return;
+	}
+
+	bitonic_sort_registers(v, count / 2);
+	bitonic_sort_registers(v + count / 2, count / 2);
+	bitonic_merge_sorted_halves(v, count);
+}
+
+SIMD_TARGET_AVX2 void bitonic_sort_avx2(int* array, int count)
+{
+	__m256i v[SMALL_SORT_MAX / 8];
+	int i;
+
+	for (i = 0; i < count; ++i) {
+		v[i] = _mm256_loadu_si256((const __m256i*)(array + 8 * i));
+	}
+
+	bitonic_sort_registers(v, count);
+
+	for (i = 0; i < count; ++i) {
+		_mm256_storeu_si256((__m256i*)(array + 8 * i), v[i]);
+	}
+}
+
+// ⳤȣ 64Ĳֲ INT_MAXֻдǰ length 
+SIMD_TARGET_AVX2 void small_sort_avx2(int* array, int length)
+{
+	__m256i v[SMALL_SORT_MAX / 8];
+	__m256i mask;
+	int i, count, full, rest;
+
+	full = length / 8;
+	rest = length % 8;
+
+	for (count = 1; count * 8 < length; count *= 2) {
+	}
+
+	mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(rest),
+		_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+
+	for (i = 0; i < full; ++i) {
+		v[i] = _mm256_loadu_si256((const __m256i*)(array + 8 * i));
+	}
+
+	for (i = full; i < count; ++i) {
+		v[i] = _mm256_set1_epi32(INT_MAX);
+	}
+
+	if (rest) {
+		v[full] = _mm256_blendv_epi8(v[full],
+			_mm256_maskload_epi32(array + 8 * full, mask), mask);
+	}
+
+	bitonic_sort_registers(v, count);
+
+	for (i = 0; i < full; ++i) {
+		_mm256_storeu_si256((__m256i*)(array + 8 * i), v[i]);
+	}
+
+	if (rest) {
+		_mm256_maskstore_epi32(array + 8 * full, mask, v[full]);
+	}
+}
+
+SIMD_TARGET_AVX2 void simd_min_max_avx2(const int* array, size_t length, int* minValue, int* maxValue)
+{
+	__m256i min0 = _mm256_set1_epi32(array[0]);
+	__m256i max0 = min0;
+	__m256i min1 = min0;
+	__m256i max1 = min0;
+	__m256i v0, v1;
+	int lanes[8];
+	int low, high;
+	size_t i;
+
+	for (i = 0; i + 16 <= length; i += 16) {
+		v0 = _mm256_loadu_si256((const __m256i*)(array + i));
+		v1 = _mm256_loadu_si256((const __m256i*)(array + i + 8));
+		min0 = _mm256_min_epi32(min0, v0);
+		max0 = _mm256_max_epi32(max0, v0);
+		min1 = _mm256_min_epi32(min1, v1);
+		max1 = _mm256_max_epi32(max1, v1);
+	}
+
+	_mm256_storeu_si256((__m256i*)lanes, _mm256_min_epi32(min0, min1));
+	low = lanes[0];
+	for (int j = 1; j < 8; ++j) {
+		low = (lanes[j] < low) ? lanes[j] : low;
+	}
+
+	_mm256_storeu_si256((__m256i*)lanes, _mm256_max_epi32(max0, max1));
+	high = lanes[0];
+	for (int j = 1; j < 8; ++j) {
+		high = (lanes[j] > high) ? lanes[j] : high;
+	}
+
+	for (; i < length; ++i) {
+		low = (array[i] < low) ? array[i] : low;
+		high = (array[i] > high) ? array[i] : high;
+	}
+
+	*minValue = low;
+	*maxValue = high;
+}
+
+// ÿδ׼¼Сһȡ SIMD_MERGE_BLOCK ¼ϴʣµ
+// ͬϴļ¼˫鲢дСһ롣ȡһɣ
+// ûݵķ֧඼һʱأ*ia*ib ΪѶĸ
+// carry Ϊδд SIMD_MERGE_BLOCK ¼
+SIMD_TARGET_AVX2 size_t simd_merge_avx2(const int* a, size_t na, const int* b, size_t nb,
+	int* out, size_t* ia, size_t* ib, int* carry)
+{
+	__m256i v[2 * SIMD_MERGE_REGISTERS];
+	size_t i = SIMD_MERGE_BLOCK, j = SIMD_MERGE_BLOCK, written = 0;
+	const int* next = b;
+	bool takeA;
+	int k;
+
+	for (k = 0; k < SIMD_MERGE_REGISTERS; ++k) {
+		v[SIMD_MERGE_REGISTERS + k] = _mm256_loadu_si256((const __m256i*)(a + 8 * k));
+	}
+
+	for (;;) {
+		for (k = 0; k < SIMD_MERGE_REGISTERS; ++k) {
+			v[k] = _mm256_loadu_si256((const __m256i*)(next + 8 * k));
+		}
+
+		bitonic_merge_sorted_halves(v, 2 * SIMD_MERGE_REGISTERS);
+
+		for (k = 0; k < SIMD_MERGE_REGISTERS; ++k) {
+			_mm256_storeu_si256((__m256i*)(out + written + 8 * k), v[k]);
+		}
+		written += SIMD_MERGE_BLOCK;
+
+		if (i + SIMD_MERGE_BLOCK > na || j + SIMD_MERGE_BLOCK > nb) {
+			break;
+		}
+
+		takeA = a[i] <= b[j];
+		next = takeA ? a + i : b + j;
+		i += takeA ? SIMD_MERGE_BLOCK : 0;
+		j += takeA ? 0 : SIMD_MERGE_BLOCK;
+	}
+
+	for (k = 0; k < SIMD_MERGE_REGISTERS; ++k) {
+		_mm256_storeu_si256((__m256i*)(carry + 8 * k), v[SIMD_MERGE_REGISTERS + k]);
+	}
+	*ia = i;
+	*ib = j;
+
+	return written;
+}
+
+#endif // SIMD_AVX2_SUPPORTED
+
+// 鲢 a[0, na)  b[0, nb)  outʱȡ a еļ¼
+void scalar_merge(const int* a, size_t na, const int* b, size_t nb, int* out)
+{
+	size_t i = 0, j = 0;
+
+	while (i < na && j < nb) {
+		if (a[i] <= b[j]) {
+			*out++ = a[i++];
+		}
+		else {
+			*out++ = b[j++];
+		}
+	}
+
+	// ԭع鲢ʱµļ¼ص
+	if (i < na) {
+		memmove(out, a + i, (na - i) * sizeof(int));
+	}
+	else if (j < nb) {
+		memmove(out, b + j, (nb - j) * sizeof(int));
+	}
+}
+
+void simd_merge(const int* a, size_t na, const int* b, size_t nb, int* out)
+{
+	assert((a || na == 0) && (b || nb == 0) && (out || na + nb == 0));
+
+#if SIMD_AVX2_SUPPORTED
+	if (na >= SIMD_MERGE_BLOCK && nb >= SIMD_MERGE_BLOCK && cpu_has_avx2()) {
+		int carry[SIMD_MERGE_BLOCK], rest[2 * SIMD_MERGE_BLOCK];
+		size_t i, j, written;
+
+		written = simd_merge_avx2(a, na, b, nb, out, &i, &j, carry);
+
+		// ʣµĲ֣carry µļ¼һ಻һ飬
+		//  carry 鲢һ鲢
+		if (na - i < SIMD_MERGE_BLOCK) {
+			scalar_merge(carry, SIMD_MERGE_BLOCK, a + i, na - i, rest);
+			scalar_merge(rest, SIMD_MERGE_BLOCK + na - i, b + j, nb - j, out + written);
+		}
+		else {
+			scalar_merge(carry, SIMD_MERGE_BLOCK, b + j, nb - j, rest);
+			scalar_merge(a + i, na - i, rest, SIMD_MERGE_BLOCK + nb - j, out + written);
+		}
+		return;
+	}
+#endif
+
+	scalar_merge(a, na, b, nb, out);
+}
+
+void bitonic_sort_8(int* array)
+{
+	assert(array);
+
+#if SIMD_AVX2_SUPPORTED
+	if (cpu_has_avx2()) {
+		bitonic_sort_avx2(array, 1);
+		return;
+	}
+#endif
+
+	insert_sort(array, 8);
+}
+
+void bitonic_sort_16(int* array)
+{
+	assert(array);
+
+#if SIMD_AVX2_SUPPORTED
+	if (cpu_has_avx2()) {
+		bitonic_sort_avx2(array, 2);
+		return;
+	}
+#endif
+
+	insert_sort(array, 16);
+}
+
+void bitonic_sort_32(int* array)
+{
+	assert(array);
+
+#if SIMD_AVX2_SUPPORTED
+	if (cpu_has_avx2()) {
+		bitonic_sort_avx2(array, 4);
+		return;
+	}
+#endif
+
+	insert_sort(array, 32);
+}
+
+void bitonic_sort_64(int* array)
+{
+	assert(array);
+
+#if SIMD_AVX2_SUPPORTED
+	if (cpu_has_avx2()) {
+		bitonic_sort_avx2(array, 8);
+		return;
+	}
+#endif
+
+	insert_sort(array, 64);
+}
+
+void small_sort(int* array, int length)
+{
+	assert(array && length >= 0);
+
+	if (length <= 1) {
+		return;
+	}
+
+#if SIMD_AVX2_SUPPORTED
+	if (length <= SMALL_SORT_MAX && cpu_has_avx2()) {
+		small_sort_avx2(array, length);
+		return;
+	}
+#endif
+
+	insert_sort(array, length);
+}
+
+void simd_min_max(const int* array, size_t length, int* minValue, int* maxValue)
+{
+	assert(array && length > 0 && minValue && maxValue);
+
+#if SIMD_AVX2_SUPPORTED
+	if (cpu_has_avx2()) {
+		simd_min_max_avx2(array, length, minValue, maxValue);
+		return;
+	}
+#endif
+
+	int low = array[0];
+	int high = array[0];
+
+	for (size_t i = 1; i < length; ++i) {
+		low = (array[i] < low) ? array[i] : low;
+		high = (array[i] > high) ? array[i] : high;
+	}
+
+	*minValue = low;
+	*maxValue = high;
+}
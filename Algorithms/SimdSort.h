@@ -0,0 +1,74 @@
+#ifndef __SIMD_SORT_H__
+#define __SIMD_SORT_H__
+
+#include <stddef.h>
+
+// ܷ AVX2 롣ʹ֧֣ʱҪ cpu_has_avx2 ⴦
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_AVX2_SUPPORTED		1
+#define SIMD_TARGET_AVX2		__attribute__((target("avx2")))
+#define SIMD_TARGET_SSSE3		__attribute__((target("ssse3")))
+#elif defined(_MSC_VER) && _MSC_VER >= 1700 && (defined(_M_X64) || defined(_M_IX86))
+#define SIMD_AVX2_SUPPORTED		1
+#define SIMD_TARGET_AVX2
+#define SIMD_TARGET_SSSE3
+#else
+#define SIMD_AVX2_SUPPORTED		0
+#define SIMD_TARGET_AVX2
+#define SIMD_TARGET_SSSE3
+#endif
+
+// ϵͳǷ֧ AVX2CPUID ⣬ᱻ棩
+bool cpu_has_avx2();
+
+// Ƿ֧ SSSE3pshufb AVX2 ʱҲ SSSE3 
+bool cpu_has_ssse3();
+
+/**
+* 㷨	 ˫磨Bitonic sorting network
+* 㷨	  AVX2  8 · min/max ûָʵ˫磬
+*             8  int һĴ16/32/64  int ȷֱźÿ
+*             Ĵ˫鲢ȽϵĴ˳޹أû
+*             ֧Ԥʧܡ֧ AVX2 ʱ˻ΪֱӲ
+* ʱ临Ӷ O(n(lgn)^2)n <= 64
+* ռ临Ӷ O(1)
+* ȶ	 
+*/
+void bitonic_sort_8(int* array);
+
+void bitonic_sort_16(int* array);
+
+void bitonic_sort_32(int* array);
+
+void bitonic_sort_64(int* array);
+
+//  array[0, length) Сֵֵlength > 0
+// ֧ AVX2 ʱÿαȽ 8 ¼ۼ min/max ָӳ١
+void simd_min_max(const int* array, size_t length, int* minValue, int* maxValue);
+
+// Сܴ󳤶
+#define SMALL_SORT_MAX		64
+
+// Բ SMALL_SORT_MAX ¼򣺳Ȳ뵽 8/16/32/64 磬
+// ֧ AVX2 򳤶ȹʱֱӲַҶ
+void small_sort(int* array, int length);
+
+/**
+* 㷨	 ˫鲢SIMD ·鲢
+* 㷨	  a[0, na)  b[0, nb) 鲢 out֧ AVX2 ʱÿδ׼¼
+*             Сһȡ 16 ¼Ĵһʣµ 16 ¼
+*             ˫鲢ϲдС 16 ȡһͣ
+*             ÿ 16 ¼ֻһαȽϣûԤķ֧
+*             ֧ AVX2 ĳһ಻ 16 ʱȽϵĹ鲢
+*             int ȵļ¼޷֣˽ȶĹ鲢ͬ
+*             out һصֻҪһһλ
+*             ֮󣨻󣩣out + nb <= a  out + na <= bԭع鲢
+* ʱ临Ӷ O(na + nb)
+* ռ临Ӷ O(1)
+*/
+void simd_merge(const int* a, size_t na, const int* b, size_t nb, int* out);
+
+// ȽϵĶ·鲢simd_merge ʹ AVX2 ʱ
+void scalar_merge(const int* a, size_t na, const int* b, size_t nb, int* out);
+
+#endif // __SIMD_SORT_H__
@@ -2,16 +2,11 @@
 #include <stdio.h>
 #include <memory.h>
 #include <assert.h>
+#include <limits.h>
 
 #include "SortAlgorithms.h"
-
-#define DEBUG_SORT
-
-#ifdef DEBUG_SORT
-#define debug_print(fmt,...) printf(fmt, ## __VA_ARGS__)
-#else
-#define debug_print(fmt,...)
-#endif
+#include "SimdSort.h"
+#include "Heap.h"
 
 // ֱӲ
 //
@@ -122,7 +117,15 @@ void bubble_sort_opt(int* array, int length)
 }
 
 
+inline void swap_int(int* a, int* b)
+{
+	int temp = *a;
+	*a = *b;
+	*b = temp;
+}
+
 //  [low, high] ֣ػ׼¼λ
+// ׼ȵļ¼Ҳͣظ¼ʱȻ
 int quick_partition(int* array, int low, int high)
 {
 	assert(array && low >= 0 && low <= high);
@@ -130,7 +133,7 @@ int quick_partition(int* array, int low, int high)
 	int pivot = array[low]; // ĵ 1 ¼Ϊ׼
 
 	while (low < high) {
-		while (low < high && array[high] >= pivot) {
+		while (low < high && array[high] > pivot) {
 			--high;
 		}
 
@@ -138,7 +141,7 @@ int quick_partition(int* array, int low, int high)
 			array[low++] = array[high];
 		}
 
-		while (low < high && array[low] <= pivot) {
+		while (low < high && array[low] < pivot) {
 			++low;
 		}
 
@@ -152,23 +155,279 @@ int quick_partition(int* array, int low, int high)
 	return low;
 }
 
-void quick_sort_impl(int* array, int low, int high)
+// 黮ÿļ¼ƫ unsigned char 
+#define QUICK_PARTITION_BLOCK_SIZE	64
+
+// 黮֣BlockQuicksort׼ [low] [low, high] ֲػ׼¼λá
+// ˸ȡһ飬޷֧ĴѿλòԵļ¼ >= pivot
+// ҿ <= pivot ļ¼ƫǵٳȽϵĽֻ
+// ۼӼתûз֧Ԥʧܡ
+// ׼ȵļ¼඼ύظ¼ʱȻ⡣
+int quick_partition_block(int* array, int low, int high)
+{
+	assert(array && low >= 0 && low <= high);
+
+	const int pivot = array[low];
+	unsigned char offsetsLeft[QUICK_PARTITION_BLOCK_SIZE];
+	unsigned char offsetsRight[QUICK_PARTITION_BLOCK_SIZE];
+	int* first = array + low + 1;	// δ [first, last)
+	int* last = array + high + 1;
+	int startLeft = 0, numLeft = 0;
+	int startRight = 0, numRight = 0;
+	int i, num, sizeLeft, sizeRight, unknown;
+
+	while (last - first > 2 * QUICK_PARTITION_BLOCK_SIZE) {
+		if (numLeft == 0) {
+			startLeft = 0;
+			for (i = 0; i < QUICK_PARTITION_BLOCK_SIZE; ++i) {
+				offsetsLeft[numLeft] = (unsigned char)i;
+				numLeft += (first[i] >= pivot);
+			}
+		}
+
+		if (numRight == 0) {
+			startRight = 0;
+			for (i = 0; i < QUICK_PARTITION_BLOCK_SIZE; ++i) {
+				offsetsRight[numRight] = (unsigned char)i;
+				numRight += (*(last - 1 - i) <= pivot);
+			}
+		}
+
+		num = (numLeft < numRight) ? numLeft : numRight;
+		for (i = 0; i < num; ++i) {
+			swap_int(first + offsetsLeft[startLeft + i],
+				last - 1 - offsetsRight[startRight + i]);
+		}
+
+		numLeft -= num;
+		numRight -= num;
+		startLeft += num;
+		startRight += num;
+
+		if (numLeft == 0) {
+			first += QUICK_PARTITION_BLOCK_SIZE;
+		}
+
+		if (numRight == 0) {
+			last -= QUICK_PARTITION_BLOCK_SIZE;
+		}
+	}
+
+	// ʣ಻飺ƫδһౣ飬һȡʣµĲ
+	unknown = (int)(last - first) - ((numLeft || numRight) ? QUICK_PARTITION_BLOCK_SIZE : 0);
+	if (numRight) {
+		sizeLeft = unknown;
+		sizeRight = QUICK_PARTITION_BLOCK_SIZE;
+	}
+	else if (numLeft) {
+		sizeLeft = QUICK_PARTITION_BLOCK_SIZE;
+		sizeRight = unknown;
+	}
+	else {
+		sizeLeft = unknown / 2;
+		sizeRight = unknown - sizeLeft;
+	}
+
+	if (unknown && numLeft == 0) {
+		startLeft = 0;
+		for (i = 0; i < sizeLeft; ++i) {
+			offsetsLeft[numLeft] = (unsigned char)i;
+			numLeft += (first[i] >= pivot);
+		}
+	}
+
+	if (unknown && numRight == 0) {
+		startRight = 0;
+		for (i = 0; i < sizeRight; ++i) {
+			offsetsRight[numRight] = (unsigned char)i;
+			numRight += (*(last - 1 - i) <= pivot);
+		}
+	}
+
+	num = (numLeft < numRight) ? numLeft : numRight;
+	for (i = 0; i < num; ++i) {
+		swap_int(first + offsetsLeft[startLeft + i],
+			last - 1 - offsetsRight[startRight + i]);
+	}
+
+	numLeft -= num;
+	numRight -= num;
+	startLeft += num;
+	startRight += num;
+
+	if (numLeft == 0) {
+		first += sizeLeft;
+	}
+
+	if (numRight == 0) {
+		last -= sizeRight;
+	}
+
+	// һ໹λòԵļ¼Ӻǰǻһһ
+	if (numLeft) {
+		while (numLeft--) {
+			swap_int(first + offsetsLeft[startLeft + numLeft], --last);
+		}
+		first = last;
+	}
+
+	if (numRight) {
+		while (numRight--) {
+			swap_int(last - 1 - offsetsRight[startRight + numRight], first++);
+		}
+		last = first;
+	}
+
+	// [low + 1, first) <= pivot <= [first, high]׼ŵ֮
+	int pivotPos = (int)(first - array) - 1;
+	swap_int(&array[low], &array[pivotPos]);
+
+	return pivotPos;
+}
+
+// 䳤ȲڸֵʱֱӲ
+#define QUICK_SORT_INSERT_CUTOFF	32
+
+// Ҷĳޡ֧ AVX2 ʱҶ磨small_sort
+// 64 ¼ʱԱȲ 4 ˿Էſ SMALL_SORT_MAX
+inline int leaf_sort_cutoff(int insertCutoff)
+{
+	return cpu_has_avx2() ? SMALL_SORT_MAX : insertCutoff;
+}
+
+// 䳤ȲСڸֵʱþȡУnintherѡȡ׼ȡ
+#define QUICK_SORT_NINTHER_THRESHOLD	128
+
+//  [a], [b], [c] ¼ʹ [b] Ϊߵֵ
+inline void sort3(int* array, int a, int b, int c)
+{
+	if (array[b] < array[a]) {
+		swap_int(&array[a], &array[b]);
+	}
+
+	if (array[c] < array[b]) {
+		swap_int(&array[b], &array[c]);
+
+		if (array[b] < array[a]) {
+			swap_int(&array[a], &array[b]);
+		}
+	}
+}
+
+// ѡȡ׼ŵ [low] quick_partition ʹ
+void quick_choose_pivot(int* array, int low, int high)
+{
+	int length = high - low + 1;
+	int mid = low + (length >> 1);
+
+	if (length >= QUICK_SORT_NINTHER_THRESHOLD) {
+		int step = length >> 3;
+
+		sort3(array, low, low + step, low + 2 * step);
+		sort3(array, mid - step, mid, mid + step);
+		sort3(array, high - 2 * step, high - step, high);
+		sort3(array, low + step, mid, high - step);
+	}
+	else {
+		sort3(array, low, mid, high);
+	}
+
+	swap_int(&array[low], &array[mid]);
+}
+
+//  [low, high] Ƿ O(n) 
+// ɨһļ¼ʱֹͣϵĿԺԡ
+bool quick_sort_presorted(int* array, int low, int high)
+{
+	int i = low + 1;
+
+	if (array[i] < array[low]) {
+		while (i < high && array[i + 1] <= array[i]) {
+			++i;
+		}
+
+		if (i < high) {
+			return false;
+		}
+
+		// 򣬷ת
+		while (low < high) {
+			swap_int(&array[low++], &array[high--]);
+		}
+
+		return true;
+	}
+
+	while (i < high && array[i] <= array[i + 1]) {
+		++i;
+	}
+
+	return (i >= high);
+}
+
+// ʡ򣺻ȳ depthLimit ʱö򣬱֤ O(nlgn)
+// ֻԽ϶̵һݹ飬ϳһѭջȲ O(lgn)
+void quick_sort_impl(int* array, int low, int high, int depthLimit, int cutoff,
+	Partition_Function partition)
 {
+	while (high - low + 1 > cutoff) {
+		if (quick_sort_presorted(array, low, high)) {
+			return;
+		}
+
+		if (depthLimit-- == 0) {
+			heap_sort(array + low, high - low + 1);
+			return;
+		}
+
+		quick_choose_pivot(array, low, high);
+
+		int pivotPos = partition(array, low, high);
+
+		if (pivotPos - low < high - pivotPos) {
+			quick_sort_impl(array, low, pivotPos - 1, depthLimit, cutoff, partition);
+			low = pivotPos + 1;
+		}
+		else {
+			quick_sort_impl(array, pivotPos + 1, high, depthLimit, cutoff, partition);
+			high = pivotPos - 1;
+		}
+	}
+
 	if (low < high) {
-		int pivotPos = quick_partition(array, low, high);
+		small_sort(array + low, high - low + 1);
+	}
+}
 
-		quick_sort_impl(array, low, pivotPos - 1);
-		quick_sort_impl(array, pivotPos + 1, high);
+Partition_Function quick_partition_function(Quick_Partition_Scheme scheme)
+{
+	switch (scheme) {
+	case QUICK_PARTITION_HOARE:
+		return quick_partition;
+	case QUICK_PARTITION_BLOCK:
+	default:
+		return quick_partition_block;
 	}
 }
 
 // 
 //
 void quick_sort(int* array, int length)
+{
+	quick_sort_ex(array, length, QUICK_PARTITION_BLOCK);
+}
+
+void quick_sort_ex(int* array, int length, Quick_Partition_Scheme scheme)
 {
 	assert(array && length >= 0);
 
-	quick_sort_impl( array, 0, length - 1);
+	int depthLimit = 0;
+	for (int n = length; n > 1; n >>= 1) {
+		depthLimit += 2;
+	}
+
+	quick_sort_impl(array, 0, length - 1, depthLimit,
+		leaf_sort_cutoff(QUICK_SORT_INSERT_CUTOFF), quick_partition_function(scheme));
 }
 
 
@@ -198,405 +457,2194 @@ void selection_sort(int* array, int length)
 }
 
 
-// ɸѡѣ [low] ֮⣬[low] ӾǴ
-void adjust_heap(int* heap, int low, int high)
+// 
+//
+void heap_sort(int* array, int length)
+{
+	assert(array && length >= 0);
+
+	int i;
+
+	//  [0, length - 1] ɳʼ
+	max_heap_build(array, length);
+
+	// Եǰ [0, i] ж򣬹 length - 1 ˣ
+	// Ѷļ¼Ƶ [i][0, i - 1] µΪ
+	for(i = length - 1; i > 0; --i) {
+		max_heap_pop(array, i + 1);
+	}
+}
+
+
+// ѡ벿
+//
+
+// 䳤Ȳڸֵʱֱ
+#define SELECT_INSERT_CUTOFF	16
+
+void select_nth_impl(int* array, int low, int high, int nth, int depthLimit);
+
+// λλBFPRTÿ 5 ¼һȡֵƵǰ
+// ٵݹѡЩֵֵΪ׼ŵ [low]
+// Ϊ׼֣඼Լ 3/10 ļ¼ѡʱΪ O(n)
+void median_of_medians_pivot(int* array, int low, int high)
 {
-	assert(heap);
+	int i, length, groups = 0;
+
+	for (i = low; i <= high; i += 5) {
+		length = (high - i + 1 < 5) ? high - i + 1 : 5;
+		insert_sort(array + i, length);
+		swap_int(&array[low + groups], &array[i + length / 2]);
+		++groups;
+	}
 
-#if 1	// ѭʵ
+	int mid = low + (groups - 1) / 2;
+	select_nth_impl(array, low, low + groups - 1, mid, 0);
+	swap_int(&array[low], &array[mid]);
+}
 
-	int i = low;
-	int j = 2 * i;
-	int temp = heap[i];
+// ʡѡÿѡ񣬻ִ depthLimit ʱλλ
+// ѡȡ׼֤ O(n)
+void select_nth_impl(int* array, int low, int high, int nth, int depthLimit)
+{
+	int pivotPos;
 
-	while (j <= high) {
-		// ӣj ΪдǸ±
-		if (j < high && heap[j] < heap[j + 1]) {
-			j = j + 1;
+	while (high - low + 1 > SELECT_INSERT_CUTOFF) {
+		if (depthLimit > 0) {
+			--depthLimit;
+			quick_choose_pivot(array, low, high);
+		}
+		else {
+			median_of_medians_pivot(array, low, high);
 		}
 
-		// Ƕ
-		if (temp >= heap[j]) {
-			break;
+		pivotPos = quick_partition_block(array, low, high);
+
+		if (pivotPos == nth) {
+			return;
 		}
 
-		// ɸѡ
+		if (nth < pivotPos) {
+			high = pivotPos - 1;
+		}
 		else {
-			heap[i] = heap[j];
-			i = j;
-			j = 2 * i;
+			low = pivotPos + 1;
 		}
 	}
 
-	heap[i] = temp;
+	insert_sort(array + low, high - low + 1);
+}
+
+void select_nth(int* array, int length, int nth)
+{
+	assert(array && nth >= 0 && nth < length);
+
+	int depthLimit = 0;
+	for (int n = length; n > 1; n >>= 1) {
+		depthLimit += 2;
+	}
 
-#else	// ݹʵ
+	select_nth_impl(array, 0, length - 1, nth, depthLimit);
+}
 
-	int i = low;
-	int j = 2 * i;
-	int temp = heap[i];
+void partial_sort(int* array, int length, int k)
+{
+	assert(array && length >= 0);
 
-	if (j >= high) {
+	if (k <= 0) {
 		return;
 	}
 
-	// ӣj ΪдǸ±
-	if (j < high && heap[j + 1] > heap[j]) {
-		j = j + 1;
+	if (k < length) {
+		select_nth(array, length, k - 1);
 	}
-
-	// ѾΪѣ
-	if (heap[low] >= heap[j]) {
-		return;
+	else {
+		k = length;
 	}
 
-	heap[i] = heap[j];
-	heap[j] = temp;
+	quick_sort(array, k);
+}
+
+bool top_k_init(Top_K* topk, int k)
+{
+	assert(topk && k > 0);
 
-	// ֮[j, high] ܲˣ
-	adjust_heap(heap, j, high);
+	topk->heap = (int*)malloc(k * sizeof(int));
+	topk->capacity = k;
+	topk->count = 0;
 
-#endif
+	return topk->heap != NULL;
 }
 
-// ֻһǶѣȫУ i > n/2 Ľ㶼Ҷӣ
-// ЩΪǶѡֻνΪ
-// n/2, n/2 - 1, , 0 ĽΪΪѼɡ
-void build_heap(int* heap, int length)
+void top_k_destroy(Top_K* topk)
 {
-	assert(heap && length >= 0);
+	assert(topk);
 
-	int i;
+	free(topk->heap);
+	topk->heap = NULL;
+	topk->capacity = 0;
+	topk->count = 0;
+}
+
+void top_k_push(Top_K* topk, int value)
+{
+	assert(topk && topk->heap);
 
-	for(i = length / 2; i >= 0; --i) {
-		adjust_heap(heap, i, length - 1);
+	// ڶѶǰ k 󣩵ļ¼ֱӶ¼ֻȽһ
+	if (topk->count == topk->capacity) {
+		if (value > topk->heap[0]) {
+			min_heap_replace_top(topk->heap, topk->count, value);
+		}
+		return;
 	}
-}
 
+	topk->heap[topk->count++] = value;
+	min_heap_push(topk->heap, topk->count);
+}
 
-// 
-//
-void heap_sort(int* array, int length)
+int top_k_result(const Top_K* topk, int* result)
 {
-	assert(array && length >= 0);
+	assert(topk && result);
 
 	int i, temp;
+	int count = topk->count;
 
-	//  [0, length - 1] ɳʼ
-	build_heap(array, length);
-
-	// Եǰ [0, i - 1] ж򣬹 length - 1 ˡ
-	for(i = length - 1; i > 0; --i) {
-		// ѶͶһ¼
-		temp = array[0];
-		array[0] = array[i];
-		array[i]= temp;
+	memcpy(result, topk->heap, count * sizeof(int));
+	quick_sort(result, count);
 
-		//  [0, i - 1] µΪѣ [0] Υ
-		adjust_heap(array, 0, i - 1);
+	// ӴС
+	for (i = 0; i < count / 2; ++i) {
+		temp = result[i];
+		result[i] = result[count - 1 - i];
+		result[count - 1 - i] = temp;
 	}
-}
 
+	return count;
+}
 
-void merge(int* array, int low, int mid, int high)
+int top_k(const int* array, int length, int k, int* result)
 {
-	assert(array && low >= 0 && low <= mid && mid <= high);
-
-	int* temp = (int*)malloc((high - low + 1) * sizeof(int));
-	if (!temp) {
-		printf("Error:out of memory!");
-		return;
-	}
+	assert(array && length >= 0 && result);
 
-	int i = low;
-	int j = mid + 1;
-	int index = 0;
+	Top_K topk;
+	int i, count;
 
-	while (i <= mid && j <= high) {
-		if (array[i] <= array[j]) {
-			temp[index++] = array[i++];
-		}
-		else {
-			temp[index++] = array[j++];
-		}
+	if (k <= 0) {
+		return 0;
 	}
 
-	while (i <= mid) {
-		temp[index++] = array[i++];
+	if (!top_k_init(&topk, k)) {
+		return -1;
 	}
 
-	while (j <= high) {
-		temp[index++] = array[j++];
+	for (i = 0; i < length; ++i) {
+		top_k_push(&topk, array[i]);
 	}
 
-	memcpy((void*)(array + low), (void*)temp, (high - low + 1) * sizeof(int)) ;
+	count = top_k_result(&topk, result);
+	top_k_destroy(&topk);
+
+	return count;
+}
+
 
-	free(temp);
+// 䳤ȲڸֵʱֱӲ
+#define MERGE_SORT_INSERT_CUTOFF	16
+
+//  src ڵ [low, mid]  [mid + 1, high] 鲢 dst  [low, high]
+void merge(const int* src, int* dst, int low, int mid, int high)
+{
+	assert(src && dst && low >= 0 && low <= mid && mid <= high);
+
+	simd_merge(src + low, mid - low + 1, src + mid + 1, high - mid, dst + low);
 }
 
-//  [0, length - 1] һ˹鲢Ϊ n  Ĺ鲢
-void merge_pass(int* array, int length, int n)
+//  src  [0, length - 1] һ˹鲢Ϊ n Ĺ鲢򣬽ŵ dst
+void merge_pass(const int* src, int* dst, int length, int n)
 {
-	assert(array && length >= 1 && n >= 1);
+	assert(src && dst && length >= 1 && n >= 1);
 
 	int i;
 	int sortLength = 2 * n;
 
 	// 鲢Ϊ n 
 	for(i = 0; i + sortLength - 1 < length; i = i + sortLength) {
-		merge(array, i, i + n - 1, i + sortLength - 1);
+		merge(src, dst, i, i + n - 1, i + sortLength - 1);
 	}
 
-	//  i + n - 1 < length - 1ʣһļֿգ鲢
 	// УкһС n, 鲢С
 	if (length - 1 > i + n - 1) {
-		merge(array, i, i + n - 1, length - 1);
+		merge(src, dst, i, i + n - 1, length - 1);
+	}
+
+	//  i + n - 1 >= length - 1ʣһļֿգ鲢
+	// ҪƵ dst С
+	else if (i < length) {
+		memcpy(dst + i, src + i, (length - i) * sizeof(int));
 	}
 }
 
 // ÷ηϽж·鲢
 //
-void merge_sort(int* array, int length)
+bool merge_sort(int* array, int length, int* temp)
 {
 	assert(array && length >= 0);
 
-	int n;
+	int run = leaf_sort_cutoff(MERGE_SORT_INSERT_CUTOFF);
 
-	for(n = 1; n < length; n = (n << 1)) {
-		merge_pass(array, length, n);
+	if (length <= run) {
+		small_sort(array, length);
+		return true;
 	}
-}
 
+	int* buffer = temp;
+	if (!buffer) {
+		buffer = (int*)malloc(length * sizeof(int));
+		if (!buffer) {
+			return false;
+		}
+	}
 
-void merge_sort_dc_impl(int* array, int low, int high)
-{
-	assert(array && low >= 0);
+	int i, n, passes;
+	int* src = array;
+	int* dst = buffer;
+	int* swap;
 
-	int mid;
-	if (low < high) {
-		mid = (low + high) >> 1;
+	// ÿ˹鲢 array  buffer ֮佻Сѡȡʼεĳȣ
+	// ʹ鲢Ϊżһǡù鲢 arrayٸơ
+	for (passes = 0, n = run; n < length; n = (n << 1)) {
+		++passes;
+	}
 
-		merge_sort_dc_impl(array, low, mid);
-		merge_sort_dc_impl(array, mid + 1, high);
+	if (passes & 1) {
+		run >>= 1;
+	}
 
-		merge(array, low, mid, high);
+	// ɳΪ run ĳʼΡint ȵļ¼޷֣
+	// Ҷӿʹòȶ硣
+	for (i = 0; i < length; i += run) {
+		small_sort(array + i, (length - i < run) ? length - i : run);
 	}
-}
 
-// ÷η½
-void merge_sort_dc(int* array, int length)
-{
-	assert(array && length >= 0);
+	for (n = run; n < length; n = (n << 1)) {
+		merge_pass(src, dst, length, n);
 
-	merge_sort_dc_impl(array, 0, length - 1);
-}
+		swap = src;
+		src = dst;
+		dst = swap;
+	}
 
-// array м¼ֵڷΧ [0, k] ֮䡣
-//
-void counting_sort(int* array, int length, int k)
-{
-	int* temp = NULL;	// a copy of array.
-	int* counts = NULL;	// for counting.
-	int i;
+	assert(src == array);
 
-	temp = (int*)malloc(sizeof(int) * length);
 	if (!temp) {
-		printf("Error: out of memory!\n");
-		return;
+		free(buffer);
 	}
 
-	counts = (int*)calloc(sizeof(int), k + 1);
-	if (!counts) {
-		printf("Error: out of memory!\n");
+	return true;
+}
+
+//  [low, high]  dst Уsrc Ϊռ䡣
+// ǰ src  dst  [low, high] м¼ͬ
+//  src Уٹ鲢 dst Уÿ㽻 src  dst Ľɫ
+void merge_sort_dc_impl(int* src, int* dst, int low, int high, int cutoff)
+{
+	assert(src && dst && low >= 0);
+
+	int mid;
 
-		if (temp) {
-			free(temp);
+	if (high - low + 1 <= cutoff) {
+		if (low < high) {
+			small_sort(dst + low, high - low + 1);
 		}
 		return;
 	}
 
-	memcpy(temp, array, sizeof(int) * length);
+	mid = (low + high) >> 1;
 
-	// 
-	for (i = 0; i < length; ++i) {
-		++counts[temp[i]];
-	}
+	merge_sort_dc_impl(dst, src, low, mid, cutoff);
+	merge_sort_dc_impl(dst, src, mid + 1, high, cutoff);
 
-	// ȷ˳
-	for (i = 1; i <= k; ++i) {
-		counts[i] += counts[i - 1];
-	}
+	merge(src, dst, low, mid, high);
+}
 
-	// 
-	for (i = 0; i < length; ++i) {
-		array[counts[temp[i]] - 1] = temp[i];
-		--counts[temp[i]];
+// ÷η½
+bool merge_sort_dc(int* array, int length, int* temp)
+{
+	assert(array && length >= 0);
+
+	int cutoff = leaf_sort_cutoff(MERGE_SORT_INSERT_CUTOFF);
+
+	if (length <= cutoff) {
+		small_sort(array, length);
+		return true;
 	}
 
-	if (temp) {
-		free(temp);
+	int* buffer = temp;
+	if (!buffer) {
+		buffer = (int*)malloc(length * sizeof(int));
+		if (!buffer) {
+			return false;
+		}
 	}
 
-	if (counts) {
-		free(counts);
+	memcpy(buffer, array, length * sizeof(int));
+
+	merge_sort_dc_impl(buffer, array, 0, length - 1, cutoff);
+
+	if (!temp) {
+		free(buffer);
 	}
+
+	return true;
 }
 
-// /ͰͻԿռ任ʱ
+// Ȼ鲢Timsort
 //
-struct bucket_node {
-	int key;
-	bucket_node* next;
+
+// Ȳڸֵʱֱ۰
+#define TIM_SORT_MIN_MERGE		64
+
+// ͬһȡô¼ɱģʽ
+#define TIM_SORT_MIN_GALLOP		7
+
+// ջȡջжγ Fibonacci ʽint ²ᳬֵ
+#define TIM_SORT_MAX_RUNS		85
+
+struct Tim_Sort_State {
+	int* array;
+	int* temp;				// 鲢ʱŽ϶̵ΣȲС length / 2
+	int minGallop;			// ɱģʽֵɱĳЧӦ
+	int runCount;
+	int runBase[TIM_SORT_MAX_RUNS];
+	int runLength[TIM_SORT_MAX_RUNS];
 };
 
-// ȡλ
-int get_max_digital_count(int* array, int length)
+// εСȣ [32, 64] ֮䣬ʹ length / minRun ǡǻС 2 ݣ
+// 鲢ʱĳȾƽ
+int tim_sort_min_run(int length)
 {
-	assert(array && length > 0);
+	int r = 0;
 
-	int i = 0;
-	int max = array[0];
-	int maxDigitalCount = 1;
+	while (length >= TIM_SORT_MIN_MERGE) {
+		r |= (length & 1);
+		length >>= 1;
+	}
 
-	for (i = 1; i < length; i++) {
-		if (max < array[i]) {
-			max = array[i];
-		}
+	return length + r;
+}
+
+// ش [low] ʼγȣָǷϸݼ
+// ϸݼĶηתΪΪûȵļ¼תӰȶԡ
+int tim_sort_count_run(const int* array, int low, int high, bool* descending)
+{
+	int i = low + 1;
+
+	*descending = false;
+
+	if (i == high) {
+		return 1;
 	}
 
-	while ((max / 10) > 0) {
-		max %= 10;
-		++maxDigitalCount;
+	if (array[i++] < array[low]) {
+		*descending = true;
+		while (i < high && array[i] < array[i - 1]) {
+			++i;
+		}
+	}
+	else {
+		while (i < high && array[i] >= array[i - 1]) {
+			++i;
+		}
 	}
 
-	return maxDigitalCount;
+	return i - low;
 }
 
-// ȡ num дӵ͵ߵ n λϵ
-int get_ditital_at(int num, int n)
+void reverse_range(int* array, int low, int high)
 {
-	while (--n > 0) {
-		num /= 10;
+	while (low < --high) {
+		swap_int(&array[low++], &array[high]);
 	}
-
-	return (num % 10);
 }
 
-// /Ͱ
-//
-void bucket_sort(int* array, int length)
+// ۰[low, start) 򣬰 [start, high) 롣
+// λȡȼ¼֮󣬱ȶ
+// ۰д޷֧ʽÿֻС䣩
+// Ϊ֧ԤʧֱܶӲ
+void binary_insert_sort(int* array, int low, int high, int start)
 {
-	assert(array && length >= 0);
+	int i, j, n, half, pivot;
+	const int* base;
 
-	if (length <= 1) {
-		return;
+	if (start == low) {
+		++start;
 	}
 
-	int i, index;
-	bucket_node* temp = NULL;
-	bucket_node bucket[10] = {0, };	// ָ 0 ~ 9  10 Ͱ
+	for (i = start; i < high; ++i) {
+		pivot = array[i];
 
-	int count = get_max_digital_count(array, length);
+		//  [low, i) ҵһ pivot λ
+		base = array + low;
+		n = i - low;
+		while (n > 1) {
+			half = n >> 1;
+			base = (base[half] <= pivot) ? base + half : base;
+			n -= half;
+		}
 
-	// ݽڵ
-	bucket_node* data = (bucket_node*)malloc(length * sizeof(bucket_node));
-	if (!data) {
-		printf("Error: out of memory!\n");
-		return;
-	}
+		int left = (int)(base - array) + (*base <= pivot);
 
-	for (i = 0; i < length; i++) {
-		data[i].key = array[i];
-		data[i].next = NULL;
+		// Ҫƶļ¼٣ƶȵ memmove 
+		for (j = i; j > left; --j) {
+			array[j] = array[j - 1];
+		}
+		array[left] = pivot;
 	}
+}
 
-	// 
-	for (i = 0; i < length; i++) {
-		index = get_ditital_at(data[i].key, count);
-		if (bucket[index].next == NULL) {
-			bucket[index].next = &data[i];
-		}
-		else {
-			temp = &bucket[index];
-			while (temp->next != NULL && temp->next->key < data[i].key) {
-				temp = temp->next;
+//  array[0, length) в key Ĳλ kʹ array[k - 1] < key <= array[k]
+//  hint ʼ 1, 3, 7, 15 ... Ĳָһڶֲң
+// Ҵ O(lg d)d Ϊ hint ľ롣
+int gallop_left(int key, const int* array, int length, int hint)
+{
+	assert(length > 0 && hint >= 0 && hint < length);
+
+	int lastOffset = 0;
+	int offset = 1;
+	int maxOffset, temp, mid;
+
+	if (key > array[hint]) {
+		// ֱ array[hint + lastOffset] < key <= array[hint + offset]
+		maxOffset = length - hint;
+		while (offset < maxOffset && key > array[hint + offset]) {
+			lastOffset = offset;
+			offset = (offset << 1) + 1;
+			if (offset <= 0) {
+				offset = maxOffset;
 			}
+		}
 
-			data[i].next = temp->next;
-			temp->next = &data[i];
+		if (offset > maxOffset) {
+			offset = maxOffset;
 		}
+
+		lastOffset += hint;
+		offset += hint;
 	}
+	else {
+		// ֱ array[hint - offset] < key <= array[hint - lastOffset]
+		maxOffset = hint + 1;
+		while (offset < maxOffset && key <= array[hint - offset]) {
+			lastOffset = offset;
+			offset = (offset << 1) + 1;
+			if (offset <= 0) {
+				offset = maxOffset;
+			}
+		}
 
-	// ռ
-	index = 0;
-	for (i = 0; i < 10; i++) {
-		temp = bucket[i].next;
-		while (temp != NULL) {
-			array[index++] = temp->key;
-			temp = temp->next;
+		if (offset > maxOffset) {
+			offset = maxOffset;
 		}
-	}
 
+		temp = lastOffset;
+		lastOffset = hint - offset;
+		offset = hint - temp;
+	}
 
-	free(data);
+	// array[lastOffset] < key <= array[offset] (lastOffset, offset] жֲ
+	++lastOffset;
+	while (lastOffset < offset) {
+		mid = lastOffset + ((offset - lastOffset) >> 1);
+		if (key > array[mid]) {
+			lastOffset = mid + 1;
+		}
+		else {
+			offset = mid;
+		}
+	}
+
+	return offset;
+}
+
+//  gallop_left ͬ key 뵽ȼ¼֮array[k - 1] <= key < array[k]
+int gallop_right(int key, const int* array, int length, int hint)
+{
+	assert(length > 0 && hint >= 0 && hint < length);
+
+	int lastOffset = 0;
+	int offset = 1;
+	int maxOffset, temp, mid;
+
+	if (key < array[hint]) {
+		maxOffset = hint + 1;
+		while (offset < maxOffset && key < array[hint - offset]) {
+			lastOffset = offset;
+			offset = (offset << 1) + 1;
+			if (offset <= 0) {
+				offset = maxOffset;
+			}
+		}
+
+		if (offset > maxOffset) {
+			offset = maxOffset;
+		}
+
+		temp = lastOffset;
+		lastOffset = hint - offset;
+		offset = hint - temp;
+	}
+	else {
+		maxOffset = length - hint;
+		while (offset < maxOffset && key >= array[hint + offset]) {
+			lastOffset = offset;
+			offset = (offset << 1) + 1;
+			if (offset <= 0) {
+				offset = maxOffset;
+			}
+		}
+
+		if (offset > maxOffset) {
+			offset = maxOffset;
+		}
+
+		lastOffset += hint;
+		offset += hint;
+	}
+
+	++lastOffset;
+	while (lastOffset < offset) {
+		mid = lastOffset + ((offset - lastOffset) >> 1);
+		if (key < array[mid]) {
+			offset = mid;
+		}
+		else {
+			lastOffset = mid + 1;
+		}
+	}
+
+	return offset;
+}
+
+// 鲢ڵ [base1, base1 + length1)  [base2, base2 + length2)
+// length1 <= length2ǰһθƵ tempҹ鲢
+// ǰѱ֤ array[base2] < array[base1]ǰһεĩβںһεȫ¼
+void tim_sort_merge_low(Tim_Sort_State* state, int base1, int length1, int base2, int length2)
+{
+	assert(length1 > 0 && length2 > 0 && base1 + length1 == base2);
+
+	int* array = state->array;
+	int* temp = state->temp;
+	int cursor1 = 0;		// temp еλ
+	int cursor2 = base2;	// һеλ
+	int dest = base1;
+	int minGallop = state->minGallop;
+	int count1, count2;
+	bool done = false;
+
+	memcpy(temp, array + base1, length1 * sizeof(int));
+
+	// һεĵһ¼һСǰһεһ¼һ
+	array[dest++] = array[cursor2++];
+	--length2;
+
+	while (!done && length2 > 0 && length1 > 1) {
+		count1 = 0;		// ǰһȡļ¼
+		count2 = 0;		// Ӻһȡļ¼
+
+		// Ƚϣֱĳһʤ minGallop 
+		while ((count1 | count2) < minGallop) {
+			if (array[cursor2] < temp[cursor1]) {
+				array[dest++] = array[cursor2++];
+				++count2;
+				count1 = 0;
+				if (--length2 == 0) {
+					done = true;
+					break;
+				}
+			}
+			else {
+				array[dest++] = temp[cursor1++];
+				++count1;
+				count2 = 0;
+				if (--length1 == 1) {
+					done = true;
+					break;
+				}
+			}
+		}
+
+		// ɱģʽ gallop һγƣֱζʤ
+		while (!done) {
+			count1 = gallop_right(array[cursor2], temp + cursor1, length1, 0);
+			if (count1 != 0) {
+				memcpy(array + dest, temp + cursor1, count1 * sizeof(int));
+				dest += count1;
+				cursor1 += count1;
+				length1 -= count1;
+				if (length1 <= 1) {
+					done = true;
+					break;
+				}
+			}
+
+			array[dest++] = array[cursor2++];
+			if (--length2 == 0) {
+				done = true;
+				break;
+			}
+
+			count2 = gallop_left(temp[cursor1], array + cursor2, length2, 0);
+			if (count2 != 0) {
+				memmove(array + dest, array + cursor2, count2 * sizeof(int));
+				dest += count2;
+				cursor2 += count2;
+				length2 -= count2;
+				if (length2 == 0) {
+					done = true;
+					break;
+				}
+			}
+
+			array[dest++] = temp[cursor1++];
+			if (--length1 == 1) {
+				done = true;
+				break;
+			}
+
+			--minGallop;
+			if (count1 < TIM_SORT_MIN_GALLOP && count2 < TIM_SORT_MIN_GALLOP) {
+				break;
+			}
+		}
+
+		// ɱû棬ٴνż
+		if (!done) {
+			if (minGallop < 0) {
+				minGallop = 0;
+			}
+			minGallop += 2;
+		}
+	}
+
+	state->minGallop = (minGallop < 1) ? 1 : minGallop;
+
+	if (length1 == 1) {
+		// ǰһֻʣǸ¼ŵ
+		memmove(array + dest, array + cursor2, length2 * sizeof(int));
+		array[dest + length2] = temp[cursor1];
+	}
+	else {
+		assert(length1 > 0 && length2 == 0);
+		memcpy(array + dest, temp + cursor1, length1 * sizeof(int));
+	}
+}
+
+//  tim_sort_merge_low Գƣlength1 > length2ѺһθƵ temp鲢
+void tim_sort_merge_high(Tim_Sort_State* state, int base1, int length1, int base2, int length2)
+{
+	assert(length1 > 0 && length2 > 0 && base1 + length1 == base2);
+
+	int* array = state->array;
+	int* temp = state->temp;
+	int cursor1 = base1 + length1 - 1;	// ǰһеλ
+	int cursor2 = length2 - 1;			// temp еλ
+	int dest = base2 + length2 - 1;
+	int minGallop = state->minGallop;
+	int count1, count2;
+	bool done = false;
+
+	memcpy(temp, array + base2, length2 * sizeof(int));
+
+	array[dest--] = array[cursor1--];
+	--length1;
+
+	while (!done && length1 > 0 && length2 > 1) {
+		count1 = 0;
+		count2 = 0;
+
+		while ((count1 | count2) < minGallop) {
+			if (temp[cursor2] < array[cursor1]) {
+				array[dest--] = array[cursor1--];
+				++count1;
+				count2 = 0;
+				if (--length1 == 0) {
+					done = true;
+					break;
+				}
+			}
+			else {
+				array[dest--] = temp[cursor2--];
+				++count2;
+				count1 = 0;
+				if (--length2 == 1) {
+					done = true;
+					break;
+				}
+			}
+		}
+
+		while (!done) {
+			count1 = length1 - gallop_right(temp[cursor2], array + base1, length1, length1 - 1);
+			if (count1 != 0) {
+				dest -= count1;
+				cursor1 -= count1;
+				length1 -= count1;
+				memmove(array + dest + 1, array + cursor1 + 1, count1 * sizeof(int));
+				if (length1 == 0) {
+					done = true;
+					break;
+				}
+			}
+
+			array[dest--] = temp[cursor2--];
+			if (--length2 == 1) {
+				done = true;
+				break;
+			}
+
+			count2 = length2 - gallop_left(array[cursor1], temp, length2, length2 - 1);
+			if (count2 != 0) {
+				dest -= count2;
+				cursor2 -= count2;
+				length2 -= count2;
+				memcpy(array + dest + 1, temp + cursor2 + 1, count2 * sizeof(int));
+				if (length2 <= 1) {
+					done = true;
+					break;
+				}
+			}
+
+			array[dest--] = array[cursor1--];
+			if (--length1 == 0) {
+				done = true;
+				break;
+			}
+
+			--minGallop;
+			if (count1 < TIM_SORT_MIN_GALLOP && count2 < TIM_SORT_MIN_GALLOP) {
+				break;
+			}
+		}
+
+		if (!done) {
+			if (minGallop < 0) {
+				minGallop = 0;
+			}
+			minGallop += 2;
+		}
+	}
+
+	state->minGallop = (minGallop < 1) ? 1 : minGallop;
+
+	if (length2 == 1) {
+		// һֻʣСǸ¼ǰһʣĲƺŵǰ
+		dest -= length1;
+		cursor1 -= length1;
+		memmove(array + dest + 1, array + cursor1 + 1, length1 * sizeof(int));
+		array[dest] = temp[cursor2];
+	}
+	else {
+		assert(length2 > 0 && length1 == 0);
+		memcpy(array + dest - (length2 - 1), temp, length2 * sizeof(int));
+	}
+}
+
+// 鲢ջе i  i + 1 
+void tim_sort_merge_at(Tim_Sort_State* state, int i)
+{
+	int* array = state->array;
+	int base1 = state->runBase[i];
+	int length1 = state->runLength[i];
+	int base2 = state->runBase[i + 1];
+	int length2 = state->runLength[i + 1];
+	int k;
+
+	state->runLength[i] = length1 + length2;
+	if (i == state->runCount - 3) {
+		state->runBase[i + 1] = state->runBase[i + 2];
+		state->runLength[i + 1] = state->runLength[i + 2];
+	}
+	--state->runCount;
+
+	// ǰһвںһ׼¼Ĳλ
+	k = gallop_right(array[base2], array + base1, length1, 0);
+	base1 += k;
+	length1 -= k;
+	if (length1 == 0) {
+		return;
+	}
+
+	// һвСǰһĩ¼Ĳλ
+	length2 = gallop_left(array[base1 + length1 - 1], array + base2, length2, length2 - 1);
+	if (length2 == 0) {
+		return;
+	}
+
+	if (length1 <= length2) {
+		tim_sort_merge_low(state, base1, length1, base2, length2);
+	}
+	else {
+		tim_sort_merge_high(state, base1, length1, base2, length2);
+	}
+}
+
+// άջжγĲʽջμΪ A, B, C, D
+// B > AC > B + AD > C + Bʱ鲢 B  AC н϶̵һ
+// Ᵽ֤γٰ Fibonacci ջΪ O(lgn)ҹ鲢೤
+void tim_sort_merge_collapse(Tim_Sort_State* state)
+{
+	int* length = state->runLength;
+	int n;
+
+	while (state->runCount > 1) {
+		n = state->runCount - 2;
+
+		if ((n > 0 && length[n - 1] <= length[n] + length[n + 1])
+			|| (n > 1 && length[n - 2] <= length[n - 1] + length[n])) {
+			if (length[n - 1] < length[n + 1]) {
+				--n;
+			}
+		}
+		else if (length[n] > length[n + 1]) {
+			break;
+		}
+
+		tim_sort_merge_at(state, n);
+	}
+}
+
+// ݴջ¹鲢е
+void tim_sort_merge_force_collapse(Tim_Sort_State* state)
+{
+	int* length = state->runLength;
+	int n;
+
+	while (state->runCount > 1) {
+		n = state->runCount - 2;
+		if (n > 0 && length[n - 1] < length[n + 1]) {
+			--n;
+		}
+
+		tim_sort_merge_at(state, n);
+	}
+}
+
+bool tim_sort(int* array, int length, int* temp)
+{
+	assert(array && length >= 0);
+
+	if (length < 2) {
+		return true;
+	}
+
+	bool descending;
+	int runLength = tim_sort_count_run(array, 0, length, &descending);
+
+	// ϸO(n) ɣҪռ
+	if (runLength == length) {
+		if (descending) {
+			reverse_range(array, 0, length);
+		}
+		return true;
+	}
+
+	Tim_Sort_State state;
+	state.array = array;
+	state.temp = temp;
+	state.minGallop = TIM_SORT_MIN_GALLOP;
+	state.runCount = 0;
+
+	if (!state.temp && length >= TIM_SORT_MIN_MERGE) {
+		state.temp = (int*)malloc((length / 2) * sizeof(int));
+		if (!state.temp) {
+			return false;
+		}
+	}
+
+	if (descending) {
+		reverse_range(array, 0, runLength);
+	}
+
+	if (length < TIM_SORT_MIN_MERGE) {
+		binary_insert_sort(array, 0, length, runLength);
+		return true;
+	}
+
+	int minRun = tim_sort_min_run(length);
+	int low = 0;
+	int remaining = length;
+
+	do {
+		if (low > 0) {
+			runLength = tim_sort_count_run(array, low, length, &descending);
+			if (descending) {
+				reverse_range(array, low, low + runLength);
+			}
+		}
+
+		// ̫ʱ۰ӳ minRun
+		// е򲿷ֲһʱöࣻint ȵ
+		// ¼޷֣ȶ粻Ӱ
+		if (runLength < minRun) {
+			int force = (remaining <= minRun) ? remaining : minRun;
+			if (runLength < force / 2 && force <= SMALL_SORT_MAX && cpu_has_avx2()) {
+				small_sort(array + low, force);
+			}
+			else {
+				binary_insert_sort(array, low, low + force, low + runLength);
+			}
+			runLength = force;
+		}
+
+		state.runBase[state.runCount] = low;
+		state.runLength[state.runCount] = runLength;
+		++state.runCount;
+		tim_sort_merge_collapse(&state);
+
+		low += runLength;
+		remaining -= runLength;
+	} while (remaining != 0);
+
+	tim_sort_merge_force_collapse(&state);
+	assert(state.runCount == 1 && state.runLength[0] == length);
+
+	if (!temp) {
+		free(state.temp);
+	}
+
+	return true;
+}
+
+// 鲢
+//
+
+// ڴʱջϻͿĳȣ 2KBֱӿ鲢䳤Ȳ֮
+#define BLOCK_MERGE_STACK_BUFFER	512
+
+// ʼεĳȣֱӲ
+#define BLOCK_MERGE_INSERT_CUTOFF	16
+
+// 鲢Ĺ
+struct Block_Merge_Workspace {
+	int* buffer;		// һ飬鲢ʱ϶̵һ
+	int bufferLength;
+	int* order;			// ʱλϵĿԭ
+	int orderLength;
+};
+
+int block_merge_sqrt(int n)
+{
+	int x = 1;
+
+	while ((long long)(x * 2) * (x * 2) <= n) {
+		x *= 2;
+	}
+
+	// x <= sqrt(n) < 2xλȷ
+	for (int bit = x / 2; bit > 0; bit /= 2) {
+		if ((long long)(x + bit) * (x + bit) <= n) {
+			x += bit;
+		}
+	}
+
+	return x;
+}
+
+// ڵ [first, middle)  [middle, last)϶̵һŵýʱηת
+void block_rotate(int* array, int first, int middle, int last, const Block_Merge_Workspace* workspace)
+{
+	int left = middle - first;
+	int right = last - middle;
+
+	if (left == 0 || right == 0) {
+		return;
+	}
+
+	if (left <= right && left <= workspace->bufferLength) {
+		memcpy(workspace->buffer, array + first, left * sizeof(int));
+		memmove(array + first, array + middle, right * sizeof(int));
+		memcpy(array + first + right, workspace->buffer, left * sizeof(int));
+	}
+	else if (right <= workspace->bufferLength) {
+		memcpy(workspace->buffer, array + middle, right * sizeof(int));
+		memmove(array + first + right, array + first, left * sizeof(int));
+		memcpy(array + first, workspace->buffer, right * sizeof(int));
+	}
+	else {
+		reverse_range(array, first, middle);
+		reverse_range(array, middle, last);
+		reverse_range(array, first, last);
+	}
+}
+
+// һ [middle, last) ŵýƵӴС롣
+//  gallop_right ҵλãǰһбļ¼ƣÿ¼ֻƶһ
+void block_merge_insert_right(int* array, int first, int middle, int last, int* buffer)
+{
+	int count = last - middle;
+	int end = middle;
+	int pos;
+
+	memcpy(buffer, array + middle, count * sizeof(int));
+
+	while (count > 0 && end > first) {
+		// ȵļ¼뵽ǰһεļ¼֮󣬱ȶ
+		pos = first + gallop_right(buffer[count - 1], array + first, end - first, end - first - 1);
+		memmove(array + pos + count, array + pos, (end - pos) * sizeof(int));
+		array[pos + count - 1] = buffer[count - 1];
+		end = pos;
+		--count;
+	}
+
+	memcpy(array + first, buffer, count * sizeof(int));
+}
+
+// ѻе rest Ŀ [block, block + blockSize) ֲ鲢
+// rest ԭλ [block - restLength, block)ѸƵöֲȷ
+// һ꣺ֻ鲢һȫһ֮Ĳ֣ʣµĲ
+// ĩβΪµ rest rest ĳȣ*restFromA ΪԴ
+int block_merge_rest(int* array, int block, int blockSize, const int* rest, int restLength,
+	bool* restFromA)
+{
+	int* out = array + block - restLength;
+	int last = rest[restLength - 1];
+	int count, kept;
+
+	// ʱǰһ A ļ¼ǰ
+	count = *restFromA ? gallop_left(last, array + block, blockSize, 0)
+		: gallop_right(last, array + block, blockSize, 0);
+
+	if (count < blockSize) {
+		// rest ꣺µ [count, blockSize) ԭزΪµ rest
+		if (*restFromA) {
+			simd_merge(rest, restLength, array + block, count, out);
+		}
+		else {
+			simd_merge(array + block, count, rest, restLength, out);
+		}
+
+		*restFromA = !*restFromA;
+		return blockSize - count;
+	}
+
+	// ꣺rest ڿһ¼֮Ĳ£Ƶĩβ
+	last = array[block + blockSize - 1];
+	count = *restFromA ? gallop_right(last, rest, restLength, restLength - 1)
+		: gallop_left(last, rest, restLength, restLength - 1);
+	kept = restLength - count;
+
+	if (*restFromA) {
+		simd_merge(rest, count, array + block, blockSize, out);
+	}
+	else {
+		simd_merge(array + block, blockSize, rest, count, out);
+	}
+
+	memcpy(out + count + blockSize, rest + count, kept * sizeof(int));
+	return kept;
+}
+
+// 鲢 [first, middle)  [middle, last)鳤Ϊ blockSize
+// 1) A ͷһĲ A0  B ĩβһĲ Bt 鰴
+//    ׼¼ʱ A ǰź˳ȹ鲢Ŀ˳ûĻƶ顣
+// 2) ңδ rest һֲ鲢Դͬʱ rest ֱ
+//    鲢һΪֹ鰴׼¼֤ļ¼֮ļ¼
+// 3)  Bt ǰĲ֡
+void block_merge_blocks(int* array, int first, int middle, int last, int blockSize,
+	const Block_Merge_Workspace* workspace)
+{
+	int* buffer = workspace->buffer;
+	int* order = workspace->order;
+	int start = first + (middle - first) % blockSize;
+	int countA = (middle - start) / blockSize;
+	int countB = (last - middle) / blockSize;
+	int end = middle + countB * blockSize;
+	int size = blockSize * sizeof(int);
+	int i, j, k, current, next;
+	int rest, restLength;
+	bool restFromA, fromA;
+
+	//  k λ start + k * blockSizeA Ϊ [0, countA)B Ϊ [countA, countA + countB)
+	i = 0;
+	j = countA;
+	k = 0;
+	while (i < countA && j < countA + countB) {
+		if (array[start + j * blockSize] < array[start + i * blockSize]) {
+			order[k++] = j++;
+		}
+		else {
+			order[k++] = i++;
+		}
+	}
+
+	while (i < countA) {
+		order[k++] = i++;
+	}
+
+	while (j < countA + countB) {
+		order[k++] = j++;
+	}
+
+	//  k λӦԭĵ order[k] 顣ػƶƶλȡ
+	for (k = 0; k < countA + countB; ++k) {
+		if (order[k] < 0 || order[k] == k) {
+			continue;
+		}
+
+		memcpy(buffer, array + start + k * blockSize, size);
+		current = k;
+		while (order[current] != k) {
+			next = order[current];
+			memcpy(array + start + current * blockSize, array + start + next * blockSize, size);
+			order[current] = ~next;
+			current = next;
+		}
+
+		memcpy(array + start + current * blockSize, buffer, size);
+		order[current] = ~k;
+	}
+
+	rest = first;
+	restLength = start - first;
+	restFromA = true;
+
+	for (k = 0; k < countA + countB; ++k) {
+		fromA = ((order[k] < 0) ? ~order[k] : order[k]) < countA;
+
+		if (fromA == restFromA || restLength == 0) {
+			rest = start + k * blockSize;
+			restLength = blockSize;
+			restFromA = fromA;
+			continue;
+		}
+
+		memcpy(buffer, array + rest, restLength * sizeof(int));
+		restLength = block_merge_rest(array, start + k * blockSize, blockSize, buffer,
+			restLength, &restFromA);
+		rest = start + (k + 1) * blockSize - restLength;
+	}
+
+	if (end < last) {
+		block_merge_insert_right(array, first, end, last, buffer);
+	}
+}
+
+// ȶԭع鲢 [first, middle)  [middle, last)
+void block_merge(int* array, int first, int middle, int last, const Block_Merge_Workspace* workspace)
+{
+	int left = middle - first;
+	int right = last - middle;
+	int blockSize, cutA, cutB;
+
+	if (left == 0 || right == 0 || array[middle - 1] <= array[middle]) {
+		return;
+	}
+
+	// B ȫС A
+	if (array[last - 1] < array[first]) {
+		block_rotate(array, first, middle, last, workspace);
+		return;
+	}
+
+	// һŵýʱֱӹ鲢
+	if (left <= workspace->bufferLength) {
+		memcpy(workspace->buffer, array + first, left * sizeof(int));
+		simd_merge(workspace->buffer, left, array + middle, right, array + first);
+		return;
+	}
+
+	if (right <= workspace->bufferLength) {
+		block_merge_insert_right(array, first, middle, last, workspace->buffer);
+		return;
+	}
+
+	// 鳤ȡ sqrt(n)ܳ order ĳȣ鲻ܳ
+	blockSize = block_merge_sqrt(left + right);
+	if ((long long)blockSize * workspace->orderLength < left + right) {
+		blockSize = (left + right - 1) / workspace->orderLength + 1;
+	}
+
+	if (blockSize <= workspace->bufferLength) {
+		block_merge_blocks(array, first, middle, last, blockSize, workspace);
+		return;
+	}
+
+	// ̫СϳһеֳĹ鲢ת鲢
+	if (left >= right) {
+		cutA = first + left / 2;
+		cutB = middle + gallop_left(array[cutA], array + middle, right, 0);
+	}
+	else {
+		cutB = middle + right / 2;
+		cutA = first + gallop_right(array[cutB], array + first, left, 0);
+	}
+
+	block_rotate(array, cutA, middle, cutB, workspace);
+	middle = cutA + (cutB - middle);
+	block_merge(array, first, cutA, middle, workspace);
+	block_merge(array, middle, cutB, last, workspace);
+}
+
+void block_merge_sort_impl(int* array, int length, const Block_Merge_Workspace* workspace)
+{
+	int low, width;
+
+	for (low = 0; low < length; low += BLOCK_MERGE_INSERT_CUTOFF) {
+		insert_sort(array + low, (length - low < BLOCK_MERGE_INSERT_CUTOFF)
+			? length - low : BLOCK_MERGE_INSERT_CUTOFF);
+	}
+
+	for (width = BLOCK_MERGE_INSERT_CUTOFF; width < length; width *= 2) {
+		for (low = 0; low < length - width; low += 2 * width) {
+			block_merge(array, low, low + width,
+				(length - low - width < width) ? length : low + 2 * width, workspace);
+		}
+	}
+}
+
+void block_merge_sort(int* array, int length, int* buffer, int bufferLength)
+{
+	assert(array && length >= 0 && (buffer || bufferLength == 0));
+
+	int stackBuffer[BLOCK_MERGE_STACK_BUFFER];
+	int stackOrder[BLOCK_MERGE_STACK_BUFFER];
+	Block_Merge_Workspace workspace;
+
+	// ߵĻһż¼һſ
+	if (bufferLength >= 2 * BLOCK_MERGE_STACK_BUFFER) {
+		workspace.buffer = buffer;
+		workspace.bufferLength = bufferLength / 2;
+		workspace.order = buffer + workspace.bufferLength;
+		workspace.orderLength = bufferLength - workspace.bufferLength;
+	}
+	else {
+		workspace.buffer = stackBuffer;
+		workspace.bufferLength = BLOCK_MERGE_STACK_BUFFER;
+		workspace.order = stackOrder;
+		workspace.orderLength = BLOCK_MERGE_STACK_BUFFER;
+	}
+
+	block_merge_sort_impl(array, length, &workspace);
+}
+
+size_t stable_sort_memory(int length, Stable_Sort_Memory memory)
+{
+	assert(length >= 0);
+
+	switch (memory) {
+	case STABLE_SORT_MEMORY_LINEAR:
+		return length * sizeof(int);
+
+	// ջϵĻʱŷ
+	case STABLE_SORT_MEMORY_SQRT:
+		return (length >= BLOCK_MERGE_STACK_BUFFER * BLOCK_MERGE_STACK_BUFFER)
+			? 2 * (block_merge_sqrt(length) + 1) * sizeof(int) : 0;
+
+	default:
+		return 0;
+	}
+}
+
+void stable_sort(int* array, int length, Stable_Sort_Memory memory)
+{
+	assert(array && length >= 0);
+
+	size_t size;
+	int* buffer;
+
+	if (memory == STABLE_SORT_MEMORY_LINEAR && merge_sort_dc(array, length)) {
+		return;
+	}
+
+	// 䲻 O(n) ĸʱ˵ O(sqrt(n))˵ջϵĻ
+	if (memory != STABLE_SORT_MEMORY_NONE) {
+		size = stable_sort_memory(length, STABLE_SORT_MEMORY_SQRT);
+		buffer = (size > 0) ? (int*)malloc(size) : NULL;
+		if (buffer) {
+			block_merge_sort(array, length, buffer, (int)(size / sizeof(int)));
+			free(buffer);
+			return;
+		}
+	}
+
+	block_merge_sort(array, length);
+}
+
+// 
+//
+
+// ֵ򲻴ڸֵʱöֱͼÿ 4 ֽڣ4 ֱͼ 256KB
+#define COUNTING_SORT_SMALL_RANGE		(1 << 14)
+
+// ֱͼĸ
+#define COUNTING_SORT_SUB_HISTOGRAMS	4
+
+// ֵΪ range ʱǷڴԤ֮ڣСֵ򣬻ڼ¼
+bool counting_sort_range_fits(unsigned long long range, size_t length)
+{
+	return range <= COUNTING_SORT_SMALL_RANGE || range <= length;
+}
+
+// ͳ array[0, length) иֵֵĴۼӵ counts[value - minValue]
+// ֵСʱֵͬ¼ܶ࣬ۼͬһÿҪһ
+// дأstore-to-load תۼӵ 4 ֱͼٺϲ
+void counting_histogram(const int* array, size_t length, int minValue, size_t range, size_t* counts)
+{
+	size_t i, v;
+	unsigned int* sub = NULL;
+
+	if (range <= COUNTING_SORT_SMALL_RANGE && length <= UINT_MAX) {
+		sub = (unsigned int*)calloc(COUNTING_SORT_SUB_HISTOGRAMS * range, sizeof(unsigned int));
+	}
+
+	if (!sub) {
+		for (i = 0; i < length; ++i) {
+			++counts[(unsigned int)(array[i] - minValue)];
+		}
+		return;
+	}
+
+	unsigned int* sub0 = sub;
+	unsigned int* sub1 = sub + range;
+	unsigned int* sub2 = sub + 2 * range;
+	unsigned int* sub3 = sub + 3 * range;
+
+	for (i = 0; i + 4 <= length; i += 4) {
+		++sub0[(unsigned int)(array[i] - minValue)];
+		++sub1[(unsigned int)(array[i + 1] - minValue)];
+		++sub2[(unsigned int)(array[i + 2] - minValue)];
+		++sub3[(unsigned int)(array[i + 3] - minValue)];
+	}
+
+	for (; i < length; ++i) {
+		++sub0[(unsigned int)(array[i] - minValue)];
+	}
+
+	for (v = 0; v < range; ++v) {
+		counts[v] += (size_t)sub0[v] + sub1[v] + sub2[v] + sub3[v];
+	}
+
+	free(sub);
+}
+
+// д [first, last) еĸֵ
+void counting_fill(int* array, int minValue, const size_t* counts, size_t first, size_t last)
+{
+	size_t v, c;
+	int value;
+
+	for (v = first; v < last; ++v) {
+		value = (int)(minValue + (long long)v);
+
+		for (c = counts[v]; c > 0; --c) {
+			*array++ = value;
+		}
+	}
+}
+
+// ֪Сֵֵʱļ
+bool counting_sort_range(int* array, int length, int minValue, int maxValue)
+{
+	unsigned long long range = (unsigned long long)((long long)maxValue - minValue) + 1;
+
+	// ֵ̫󣬼Ų£û
+	if (!counting_sort_range_fits(range, length)) {
+		return radix_sort(array, length);
+	}
+
+	size_t* counts = (size_t*)calloc((size_t)range, sizeof(size_t));
+	if (!counts) {
+		return radix_sort(array, length);
+	}
+
+	counting_histogram(array, length, minValue, (size_t)range, counts);
+
+	// int ¼ǹؼ֣ͬļ¼޷ֱ֣дɣҪ
+	counting_fill(array, minValue, counts, 0, (size_t)range);
+
+	free(counts);
+
+	return true;
+}
+
+bool counting_sort_auto(int* array, int length)
+{
+	assert(array && length >= 0);
+
+	int minValue, maxValue;
+
+	if (length <= 1) {
+		return true;
+	}
+
+	simd_min_max(array, length, &minValue, &maxValue);
+
+	return counting_sort_range(array, length, minValue, maxValue);
+}
+
+// ԭĽӿڣk ѲҪֵԶҲ
+//
+void counting_sort(int* array, int length, int k)
+{
+	(void)k;
+
+	if (!counting_sort_auto(array, length)) {
+		printf("Error: out of memory!\n");
+	}
+}
+
+// /Ͱ
+//
+
+// ¼ڸֵʱֱӵ quick_sort
+#define SAMPLE_SORT_BASE			2048
+
+// Ͱ 1 << 7 = 128 ͬͰ 256 ͰſԷŽһֽ
+#define SAMPLE_SORT_MAX_LOG_BUCKETS	7
+#define SAMPLE_SORT_MAX_BUCKETS		(1 << SAMPLE_SORT_MAX_LOG_BUCKETS)
+
+// ÿͰϵԽͰĴСԽ
+#define SAMPLE_SORT_OVERSAMPLE		16
+
+// ¼ѡͰĶÿͰԼ SAMPLE_SORT_BASE ¼
+int sample_sort_log_buckets(size_t length)
+{
+	int logBuckets = 1;
+
+	while (logBuckets < SAMPLE_SORT_MAX_LOG_BUCKETS
+		&& ((size_t)SAMPLE_SORT_BASE << logBuckets) < length) {
+		++logBuckets;
+	}
+
+	return logBuckets;
+}
+
+//  splitters ȫ treeţΪ tree[1]
+void sample_sort_fill_tree(int* tree, int node, int count, const int* splitters, int* pos)
+{
+	if (node >= count) {
+		return;
+	}
+
+	sample_sort_fill_tree(tree, 2 * node, count, splitters, pos);
+	tree[node] = splitters[(*pos)++];
+	sample_sort_fill_tree(tree, 2 * node + 1, count, splitters, pos);
+}
+
+//  array ѡָԪأطͰĶ logBuckets
+// splitters[0, 2^k - 1) ΪķָԪأsplitters[2^k - 1] Ϊڱtree ΪӦ
+// ظķָԪʱظĹؼ֣*equal Ϊ trueÿָԪ
+// һͰֻȵļ¼ЩͰҪȵؼֲ
+// м¼ͬһͰ
+int sample_sort_build_splitters(const int* array, size_t length, int logBuckets,
+	int* tree, int* splitters, bool* equal)
+{
+	int sample[SAMPLE_SORT_MAX_BUCKETS * SAMPLE_SORT_OVERSAMPLE];
+	int sampleSize = (SAMPLE_SORT_OVERSAMPLE << logBuckets) - 1;
+	int buckets = 1 << logBuckets;
+	int i, count, pos;
+	size_t seed = length * 0x9E3779B97F4A7C15ull + 1;
+
+	assert(length >= (size_t)sampleSize);
+
+	// xorshift αֻ볤йأԸ
+	for (i = 0; i < sampleSize; ++i) {
+		seed ^= seed << 13;
+		seed ^= seed >> 7;
+		seed ^= seed << 17;
+		sample[i] = array[seed % length];
+	}
+
+	quick_sort(sample, sampleSize);
+
+	// Ⱦȡ buckets - 1 ָԪأȥظ
+	count = 0;
+	for (i = SAMPLE_SORT_OVERSAMPLE - 1; i < sampleSize; i += SAMPLE_SORT_OVERSAMPLE) {
+		if (count == 0 || sample[i] != splitters[count - 1]) {
+			splitters[count++] = sample[i];
+		}
+	}
+
+	// ֻһָԪʱҲҪͰǡֵм¼
+	// һͰݹ鲻С
+	*equal = (count < buckets - 1 || count == 1);
+
+	// ȥغü
+	logBuckets = 1;
+	while ((1 << logBuckets) - 1 < count) {
+		++logBuckets;
+	}
+	buckets = 1 << logBuckets;
+
+	// һָԪز룬ָͬԪ֮Ͱǿյ
+	for (i = count; i < buckets; ++i) {
+		splitters[i] = splitters[count - 1];
+	}
+
+	pos = 0;
+	sample_sort_fill_tree(tree, 1, buckets, splitters, &pos);
+
+	return logBuckets;
 }
 
-// 
-//
-void radix_sort(int* array, int length)
+// ޷֧Уõ key ͰͰ j еļ¼
+// splitters[j - 1] < key < splitters[j]Ͱʱ <= splitters[j]ûͰʱ
+inline int sample_sort_bucket(const int* tree, int logBuckets, int key)
 {
-	assert(array && length >= 0);
+	int b = 1;
 
-	if (length <= 1) {
+	for (int level = 0; level < logBuckets; ++level) {
+		b = 2 * b + (tree[b] < key);
+	}
+
+	return b - (1 << logBuckets);
+}
+
+//  array ÿ¼Ͱд oracle ۼӵ counts
+// һͬʱ 4 ¼4 Ĳ·ԲִС
+void sample_sort_classify(const int* array, size_t length, const int* tree, const int* splitters,
+	int logBuckets, bool equal, unsigned char* oracle, size_t* counts)
+{
+	size_t i;
+	int b0, b1, b2, b3;
+
+	for (i = 0; i + 4 <= length; i += 4) {
+		b0 = sample_sort_bucket(tree, logBuckets, array[i]);
+		b1 = sample_sort_bucket(tree, logBuckets, array[i + 1]);
+		b2 = sample_sort_bucket(tree, logBuckets, array[i + 2]);
+		b3 = sample_sort_bucket(tree, logBuckets, array[i + 3]);
+
+		if (equal) {
+			b0 = 2 * b0 + (array[i] == splitters[b0]);
+			b1 = 2 * b1 + (array[i + 1] == splitters[b1]);
+			b2 = 2 * b2 + (array[i + 2] == splitters[b2]);
+			b3 = 2 * b3 + (array[i + 3] == splitters[b3]);
+		}
+
+		oracle[i] = (unsigned char)b0;
+		oracle[i + 1] = (unsigned char)b1;
+		oracle[i + 2] = (unsigned char)b2;
+		oracle[i + 3] = (unsigned char)b3;
+
+		++counts[b0];
+		++counts[b1];
+		++counts[b2];
+		++counts[b3];
+	}
+
+	for (; i < length; ++i) {
+		b0 = sample_sort_bucket(tree, logBuckets, array[i]);
+		if (equal) {
+			b0 = 2 * b0 + (array[i] == splitters[b0]);
+		}
+
+		oracle[i] = (unsigned char)b0;
+		++counts[b0];
+	}
+}
+
+//  array temp  oracle Ϊͬȵĸռ
+void sample_sort_impl(int* array, int* temp, unsigned char* oracle, size_t length)
+{
+	int tree[SAMPLE_SORT_MAX_BUCKETS];
+	int splitters[SAMPLE_SORT_MAX_BUCKETS];
+	size_t starts[2 * SAMPLE_SORT_MAX_BUCKETS + 1];
+	size_t offsets[2 * SAMPLE_SORT_MAX_BUCKETS];
+	size_t i, size;
+	int b, buckets, logBuckets;
+	bool equal;
+
+	if (length <= SAMPLE_SORT_BASE) {
+		quick_sort(array, (int)length);
 		return;
 	}
 
-	const int buffer_size = length * sizeof(int);
+	logBuckets = sample_sort_build_splitters(array, length,
+		sample_sort_log_buckets(length), tree, splitters, &equal);
+	buckets = (1 << logBuckets) * (equal ? 2 : 1);
+
+	// 
+	memset(offsets, 0, buckets * sizeof(size_t));
+	sample_sort_classify(array, length, tree, splitters, logBuckets, equal, oracle, offsets);
+
+	starts[0] = 0;
+	for (b = 0; b < buckets; ++b) {
+		starts[b + 1] = starts[b] + offsets[b];
+		offsets[b] = starts[b];
+	}
+
+	// 䣺ÿͰ temp һ
+	for (i = 0; i < length; ++i) {
+		temp[offsets[oracle[i]]++] = array[i];
+	}
+
+	memcpy(array, temp, length * sizeof(int));
+
+	// ͰֱͰеļ¼ͬҪ
+	for (b = 0; b < buckets; ++b) {
+		size = starts[b + 1] - starts[b];
+		if (size > 1 && !(equal && (b & 1))) {
+			sample_sort_impl(array + starts[b], temp + starts[b], oracle + starts[b], size);
+		}
+	}
+}
+
+bool sample_sort(int* array, int length, int* temp)
+{
+	assert(array && length >= 0);
+
+	if (length <= SAMPLE_SORT_BASE) {
+		quick_sort(array, length);
+		return true;
+	}
+
+	unsigned char* oracle = (unsigned char*)malloc(length);
+	int* buffer = temp ? temp : (int*)malloc(length * sizeof(int));
+	if (!oracle || !buffer) {
+		free(oracle);
+		if (!temp) {
+			free(buffer);
+		}
+		return false;
+	}
 
-	int i, k, count, index;
-	int bucket[10] = {0, };	// ָ 0 ~ 9  10 Ͱ
+	sample_sort_impl(array, buffer, oracle, length);
 
-	int* temp = (int*)malloc(buffer_size);
+	free(oracle);
 	if (!temp) {
+		free(buffer);
+	}
+
+	return true;
+}
+
+// /Ͱԭλʮֳַ 10 
+// ݼͰʱ˻Ϊ O(n^2)ʵ
+//
+void bucket_sort(int* array, int length)
+{
+	if (!sample_sort(array, length)) {
 		printf("Error: out of memory!\n");
-		return;
 	}
+}
 
-	count = get_max_digital_count(array, length);
+// ÿ˴λͰ
+#define RADIX_BITS		8
+#define RADIX_BUCKETS	(1 << RADIX_BITS)
+#define RADIX_MASK		(RADIX_BUCKETS - 1)
 
-	for (k = 1; k <= count; ++k) {
-		memset(bucket, 0, 10 * sizeof(int));
+// Ĺؼֱ任Ѽ¼ӳΪͬλ޷޷Ƚϵ
+// ˳Ǽ¼˳ʱֻͨ Record ͷʼ¼鵱 Key 
+// дλģʽ memcpy ȡΥϸ
+//
+// зתλǰ
+template <typename Record, typename Key, Key SignBit>
+struct Radix_Signed_Key {
+	static Key key(Record record) { return (Key)record ^ SignBit; }
+};
 
-		// ͳƸͰԪصĸ
-		for (i = 0; i < length; ++i) {
-			index = get_ditital_at(array[i], k);
-			++bucket[index];
+template <typename Key>
+struct Radix_Unsigned_Key {
+	static Key key(Key record) { return record; }
+};
+
+// IEEE 754 תλתλֵԽԽС
+//  -inf <  < -0.0 < +0.0 <  < +infNaN ۷Ŷ
+//  +inf ֮NaN ֮䰴λģʽС
+template <typename Record, typename Key, Key SignBit, Key Infinity>
+struct Radix_Float_Key {
+	static Key key(Record record)
+	{
+		Key bits;
+		memcpy(&bits, &record, sizeof(Key));
+
+		Key negative = (Key)0 - (bits >> (sizeof(Key) * 8 - 1));
+
+		if ((bits & ~SignBit) > Infinity) {
+			return bits | SignBit;
+		}
+
+		return bits ^ (negative | SignBit);
+	}
+};
+
+// LSD ÿ 8 λΪһ֡temp ΪΪ length ĸ顣
+// ȡ֮ǰ Transform::key Ѽ¼任Ϊ޷ Key¼ֲ䡣
+template <typename Record, typename Key, typename Transform>
+void radix_sort_bits(Record* array, Record* temp, size_t length)
+{
+	const int passes = sizeof(Key) * 8 / RADIX_BITS;
+
+	size_t counts[sizeof(Key) * 8 / RADIX_BITS][RADIX_BUCKETS];
+	size_t i, sum, count;
+	int p, d, shift;
+	Key key;
+	Record* src = array;
+	Record* dst = temp;
+	Record* swap;
+
+	memset(counts, 0, sizeof(counts));
+
+	// ֻһݣͬʱͳ˵Ͱ
+	for (i = 0; i < length; ++i) {
+		key = Transform::key(array[i]);
+
+		for (p = 0; p < passes; ++p) {
+			++counts[p][(key >> (p * RADIX_BITS)) & RADIX_MASK];
+		}
+	}
+
+	key = Transform::key(array[0]);
+
+	for (p = 0; p < passes; ++p) {
+		shift = p * RADIX_BITS;
+
+		// йؼһλ϶ͬһ˲ı˳
+		// ʱ֮Ĺؼָλͬ64 λ 8 ֻͨҪ 45 
+		if (counts[p][(key >> shift) & RADIX_MASK] == length) {
+			continue;
+		}
+
+		// ΪÿͰʼ±
+		for (sum = 0, d = 0; d < RADIX_BUCKETS; ++d) {
+			count = counts[p][d];
+			counts[p][d] = sum;
+			sum += count;
 		}
 
-		// Ϊÿ¼±
-		for (i = 1; i < 10; ++i) {
-			bucket[i] += bucket[i - 1];
+		// ±˳䣬ȶ
+		for (i = 0; i < length; ++i) {
+			dst[counts[p][(Transform::key(src[i]) >> shift) & RADIX_MASK]++] = src[i];
 		}
 
-		// ±˳
-		for (i = length - 1; i >= 0; --i) {
-			index = get_ditital_at(array[i], k);
-			assert(bucket[index] - 1 >= 0);
-			temp[--bucket[index]] = array[i];
+		swap = src;
+		src = dst;
+		dst = swap;
+	}
+
+	// ִˣ temp 
+	if (src != array) {
+		memcpy(array, src, length * sizeof(Record));
+	}
+}
+
+// 丨飨temp Ϊ NULL ʱ Transform Record  Key λͬ
+template <typename Record, typename Key, typename Transform>
+bool radix_sort_records(Record* array, size_t length, Record* temp)
+{
+	assert(array || length == 0);
+
+	if (length <= 1) {
+		return true;
+	}
+
+	Record* buffer = temp;
+	if (!buffer) {
+		buffer = (Record*)malloc(length * sizeof(Record));
+		if (!buffer) {
+			return false;
 		}
+	}
+
+	radix_sort_bits<Record, Key, Transform>(array, buffer, length);
+
+	if (!temp) {
+		free(buffer);
+	}
+
+	return true;
+}
+
+// 
+//
+bool radix_sort(int* array, size_t length, int* temp)
+{
+	return radix_sort_records<int, unsigned int,
+		Radix_Signed_Key<int, unsigned int, 0x80000000u> >(array, length, temp);
+}
+
+// 64 λĻ
+//
+bool radix_sort_int64(long long* array, size_t length, long long* temp)
+{
+	return radix_sort_records<long long, unsigned long long,
+		Radix_Signed_Key<long long, unsigned long long, 0x8000000000000000ull> >(array, length, temp);
+}
+
+bool radix_sort_uint64(unsigned long long* array, size_t length, unsigned long long* temp)
+{
+	return radix_sort_records<unsigned long long, unsigned long long,
+		Radix_Unsigned_Key<unsigned long long> >(array, length, temp);
+}
+
+// Ļ򣺰λģʽ任float  unsigned intdouble 
+// unsigned long long λͬ
+//
+bool radix_sort_float(float* array, size_t length, float* temp)
+{
+	return radix_sort_records<float, unsigned int,
+		Radix_Float_Key<float, unsigned int, 0x80000000u, 0x7F800000u> >(array, length, temp);
+}
+
+bool radix_sort_double(double* array, size_t length, double* temp)
+{
+	return radix_sort_records<double, unsigned long long,
+		Radix_Float_Key<double, unsigned long long, 0x8000000000000000ull, 0x7FF0000000000000ull> >(
+		array, length, temp);
+}
+
+// Ͱм¼ڸֵʱֱӲ
+#define AMERICAN_FLAG_INSERT_CUTOFF		32
+
+// תλȡ value д shift ʼ 8 λ
+inline int msd_digit(int value, int shift)
+{
+	return (int)((((unsigned int)value ^ 0x80000000u) >> shift) & RADIX_MASK);
+}
 
-		// һͰϣ
-		memcpy(array, temp, buffer_size);
+//  shift ʼ 8 λ [0, length - 1] ԭطֵ 256 ͰУٶԸͰݹ鴦λ
+void american_flag_sort_impl(int* array, int length, int shift)
+{
+	int counts[RADIX_BUCKETS];
+	int heads[RADIX_BUCKETS];	// Ͱһõλ
+	int tails[RADIX_BUCKETS];	// ͰĽλ
+	int i, d, b, sum, value, temp;
+
+	for (;;) {
+		if (length <= AMERICAN_FLAG_INSERT_CUTOFF) {
+			small_sort(array, length);
+			return;
+		}
 
-#ifdef DEBUG_SORT
-		debug_print("  %d ", k);
+		memset(counts, 0, sizeof(counts));
 		for (i = 0; i < length; ++i) {
-			debug_print("%d ", array[i]);
+			++counts[msd_digit(array[i], shift)];
+		}
+
+		// м¼ͬһͰУֱӴһλ
+		if (counts[msd_digit(array[0], shift)] != length) {
+			break;
+		}
+
+		if (shift == 0) {
+			return;
+		}
+
+		shift -= RADIX_BITS;
+	}
+
+	for (sum = 0, d = 0; d < RADIX_BUCKETS; ++d) {
+		heads[d] = sum;
+		sum += counts[d];
+		tails[d] = sum;
+	}
+
+	// ͰãȡڵǰͰļ¼ûŵͰУ
+	// ֱһڵǰͰļ¼Ϊֹ
+	for (d = 0; d < RADIX_BUCKETS; ++d) {
+		while (heads[d] < tails[d]) {
+			value = array[heads[d]];
+			b = msd_digit(value, shift);
+
+			while (b != d) {
+				temp = array[heads[b]];
+				array[heads[b]++] = value;
+				value = temp;
+				b = msd_digit(value, shift);
+			}
+
+			array[heads[d]++] = value;
+		}
+	}
+
+	if (shift == 0) {
+		return;
+	}
+
+	for (d = 0; d < RADIX_BUCKETS; ++d) {
+		if (counts[d] > 1) {
+			american_flag_sort_impl(array + tails[d] - counts[d], counts[d], shift - RADIX_BITS);
+		}
+	}
+}
+
+// ԭ MSD American flag sort
+//
+void american_flag_sort(int* array, int length)
+{
+	assert(array && length >= 0);
+
+	american_flag_sort_impl(array, length, 32 - RADIX_BITS);
+}
+
+
+// ѡ㷨
+//
+
+// ¼ڸֵʱֱӲ
+#define SMART_SORT_INSERT_MAX		16
+
+// ¼Сڸֵʱû򣬷 quick_sort
+#define SMART_SORT_RADIX_MIN		512
+
+// ¼СڸֵʱΪȼǷֵȡ
+// Լ 1.5 usÿ¼ֻԼ 0.7 ns16K ¼ʱҪ໨ 10% 
+#define SMART_SORT_SAMPLE_MIN		32768
+
+// ȵĶÿεĳȣ¼ʱһЩ
+#define SMART_SORT_RUN_BLOCKS		16
+#define SMART_SORT_RUN_LENGTH		32
+#define SMART_SORT_SMALL_RUN_BLOCKS	4
+#define SMART_SORT_SMALL_RUN_LENGTH	16
+
+// ȾԵͳΪ O(m^2)
+#define SMART_SORT_SAMPLE_MAX		32
+
+// Ȳڸֵʱ tim_sort
+#define SMART_SORT_PRESORTED		0.9
+
+// ظıڸֵʱû
+#define SMART_SORT_DUPLICATED		0.5
+
+// ȡɶļ¼ͳ
+void smart_sort_measure_runs(const int* array, int length, int blocks, int run, Sort_Profile* profile)
+{
+	int b, i, begin, step, up, down, agree = 0, pairs = 0;
+
+	if (length < blocks * run) {
+		blocks = 1;
+		run = length;
+	}
+
+	// εļֻһΣÿζһ 64 λ1000 ¼ʱͳƱ
+	step = (blocks == 1) ? 0 : (length - run) / (blocks - 1);
+
+	for (b = 0; b < blocks; ++b) {
+		// δ¾ȷֲһĩβ
+		begin = (b == blocks - 1) ? length - run : b * step;
+		up = down = 0;
+
+		for (i = begin + 1; i < begin + run; ++i) {
+			up += (array[i - 1] < array[i]);
+			down += (array[i - 1] > array[i]);
+		}
+
+		// ȵڶκηһ
+		agree += run - 1 - (up < down ? up : down);
+		pairs += run - 1;
+	}
+
+	profile->runPairs = pairs;
+	profile->sortedness = pairs > 0 ? (double)agree / pairs : 1.0;
+}
+
+// Ⱦͳظı
+void smart_sort_measure_sample(const int* array, int length, Sort_Profile* profile)
+{
+	int sample[SMART_SORT_SAMPLE_MAX];
+	int count = length / 32;
+	int i, j, inversions = 0, duplicates = 0;
+
+	if (count > SMART_SORT_SAMPLE_MAX) {
+		count = SMART_SORT_SAMPLE_MAX;
+	}
+	if (count < 2) {
+		profile->inversionRatio = 0;
+		profile->duplicateRatio = 0;
+		return;
+	}
+
+	for (i = 0; i < count; ++i) {
+		sample[i] = array[(long long)length * i / count];
+	}
+
+	for (i = 0; i < count; ++i) {
+		for (j = i + 1; j < count; ++j) {
+			inversions += (sample[i] > sample[j]);
+		}
+	}
+
+	insert_sort(sample, count);
+
+	for (i = 1; i < count; ++i) {
+		duplicates += (sample[i] == sample[i - 1]);
+	}
+
+	profile->inversionRatio = (double)inversions / ((double)count * (count - 1) / 2);
+	profile->duplicateRatio = (double)duplicates / count;
+}
+
+// 򷵻 1彵򷵻 -1򷵻 0
+// ȿסСβ¼һʱɨ裨󽵵ݣ
+int smart_sort_direction(const int* array, int length)
+{
+	int first = array[0];
+	int middle = array[length / 2];
+	int last = array[length - 1];
+	int i;
+
+	if (first <= middle && middle <= last) {
+		for (i = 1; i < length && array[i - 1] <= array[i]; ++i) {
+		}
+
+		if (i == length) {
+			return 1;
 		}
+	}
+
+	if (first >= middle && middle >= last) {
+		for (i = 1; i < length && array[i - 1] >= array[i]; ++i) {
+		}
+
+		if (i == length) {
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+// ¼ʱķСμ
+void smart_sort_analyze_small(const int* array, int length, Sort_Profile* profile)
+{
+	int direction = smart_sort_direction(array, length);
+
+	if (direction != 0) {
+		profile->sortedness = 1.0;
+		profile->inversionRatio = (direction < 0) ? 1.0 : 0.0;
+		profile->choice = SORT_CHOICE_PRESORTED;
+		return;
+	}
+
+	simd_min_max(array, length, &profile->minValue, &profile->maxValue);
+	profile->rangeKnown = true;
+
+	unsigned long long range = (unsigned long long)((long long)profile->maxValue - profile->minValue) + 1;
+
+	if (range <= (unsigned long long)length && counting_sort_range_fits(range, length)) {
+		profile->choice = SORT_CHOICE_COUNTING;
+		return;
+	}
+
+	smart_sort_measure_runs(array, length, SMART_SORT_SMALL_RUN_BLOCKS, SMART_SORT_SMALL_RUN_LENGTH, profile);
+
+	if (profile->sortedness >= SMART_SORT_PRESORTED) {
+		profile->choice = SORT_CHOICE_NATURAL_MERGE;
+	}
+	else if (length >= SMART_SORT_RADIX_MIN) {
+		profile->choice = SORT_CHOICE_RADIX;
+	}
+	else {
+		profile->choice = SORT_CHOICE_INTROSORT;
+	}
+}
+
+void smart_sort_analyze(const int* array, int length, Sort_Profile* profile)
+{
+	assert(array && length >= 0 && profile);
+
+	memset(profile, 0, sizeof(Sort_Profile));
+	profile->length = length;
+
+	if (length <= SMART_SORT_INSERT_MAX) {
+		profile->sortedness = 1.0;
+		profile->choice = SORT_CHOICE_INSERTION;
+		return;
+	}
+
+	if (length < SMART_SORT_SAMPLE_MIN) {
+		smart_sort_analyze_small(array, length, profile);
+		return;
+	}
+
+	profile->sampled = true;
+
+	smart_sort_measure_runs(array, length, SMART_SORT_RUN_BLOCKS, SMART_SORT_RUN_LENGTH, profile);
+	smart_sort_measure_sample(array, length, profile);
+
+	// һΣ򣩣tim_sort ֻҳΣֵ
+	if (profile->sortedness >= 0.99
+		&& (profile->inversionRatio <= 0.01 || profile->inversionRatio >= 0.99)) {
+		profile->choice = SORT_CHOICE_NATURAL_MERGE;
+		return;
+	}
+
+	simd_min_max(array, length, &profile->minValue, &profile->maxValue);
+	profile->rangeKnown = true;
+
+	unsigned long long range = (unsigned long long)((long long)profile->maxValue - profile->minValue) + 1;
+
+	if (range <= (unsigned long long)length && counting_sort_range_fits(range, length)) {
+		profile->choice = SORT_CHOICE_COUNTING;
+	}
+	else if (profile->sortedness >= SMART_SORT_PRESORTED) {
+		profile->choice = SORT_CHOICE_NATURAL_MERGE;
+	}
+	else if (length >= SMART_SORT_RADIX_MIN && profile->duplicateRatio < SMART_SORT_DUPLICATED) {
+		profile->choice = SORT_CHOICE_RADIX;
+	}
+	else {
+		profile->choice = SORT_CHOICE_INTROSORT;
+	}
+}
+
+void smart_sort(int* array, int length, Sort_Profile* profile)
+{
+	assert(array && length >= 0);
+
+	Sort_Profile local;
+	bool done = true;
+
+	if (!profile) {
+		profile = &local;
+	}
+
+	smart_sort_analyze(array, length, profile);
+
+	switch (profile->choice) {
+	case SORT_CHOICE_INSERTION:
+		insert_sort(array, length);
+		break;
+
+	case SORT_CHOICE_PRESORTED:
+		if (profile->inversionRatio > 0) {
+			reverse_range(array, 0, length);
+		}
+		break;
 
-		debug_print("\n");
-#endif
+	case SORT_CHOICE_NATURAL_MERGE:
+		done = tim_sort(array, length);
+		break;
+
+	case SORT_CHOICE_COUNTING:
+		done = counting_sort_range(array, length, profile->minValue, profile->maxValue);
+		break;
+
+	case SORT_CHOICE_RADIX:
+		done = radix_sort(array, length);
+		break;
+
+	default:
+		quick_sort(array, length);
+		break;
+	}
+
+	// ռʧܣòҪռ quick_sort
+	if (!done) {
+		profile->choice = SORT_CHOICE_INTROSORT;
+		quick_sort(array, length);
 	}
+}
 
-	free(temp);
+const char* sort_choice_name(Sort_Choice choice)
+{
+	switch (choice) {
+	case SORT_CHOICE_INSERTION:			return "insert_sort";
+	case SORT_CHOICE_INTROSORT:			return "quick_sort";
+	case SORT_CHOICE_NATURAL_MERGE:		return "tim_sort";
+	case SORT_CHOICE_COUNTING:			return "counting_sort";
+	case SORT_CHOICE_RADIX:				return "radix_sort";
+	case SORT_CHOICE_PRESORTED:			return "presorted";
+	default:							return "unknown";
+	}
 }
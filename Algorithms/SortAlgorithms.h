@@ -1,6 +1,8 @@
 #ifndef __SORT_ALGORITHMS_H__
 #define __SORT_ALGORITHMS_H__
 
+#include <stddef.h>
+
 /**
 * 㷨	 ֱӲ
 * 㷨	 δѡ¼뵽еĺλʹ֮Ȼ
@@ -57,12 +59,33 @@ void bubble_sort_opt(int* array, int length);
 *              [pivotpos + 1, high]ʹм¼Сڵڻ׼¼
 *             ұߵм¼ڵڻ׼¼
 *             ͨݹÿлֱ֣ÿֻһ¼
-* ʱ临Ӷ ƽO(nlgn)O(n^2)
+*             ʵֵʡIntrosort
+*             1) ȡ/ȡѡȡ׼˻
+*             2) ȵݹ϶̵䣬ϳѭջ O(lgn)
+*             3) ȳ 2lgn ʱö
+*             4)  O(n) ֱɣ
+*             5) С磨small_sortֱӲ
+*             Ĭʹÿ黮֣quick_sort_ex ѡ񻮷ַ
+* ʱ临Ӷ ƽO(nlgn)O(nlgn)/O(n)
 * ռ临Ӷ O(lgn)
 * ȶ	 
 */
 void quick_sort(int* array, int length);
 
+// Ļַ
+enum Quick_Partition_Scheme {
+	QUICK_PARTITION_HOARE,	// ˽ɨ裬ÿαȽ϶һԤķ֧
+	QUICK_PARTITION_BLOCK	// 黮֣BlockQuicksort޷֧ؼ¼λòԵļ¼ٳ
+};
+
+typedef int (*Partition_Function)(int* array, int low, int high);
+
+// ػַӦĻֺֺ [low, high]  [low] Ϊ׼֣
+// ػ׼¼λá
+Partition_Function quick_partition_function(Quick_Partition_Scheme scheme);
+
+void quick_sort_ex(int* array, int length, Quick_Partition_Scheme scheme);
+
 
 /**
 * 㷨	  ֱѡѡһ֣
@@ -79,10 +102,11 @@ void selection_sort(int* array, int length);
 
 /**
 * 㷨	 ѡһ֣
-* 㷨	 У [0, length - 1] һȫ
-*             ˳洢ṹȫ˫׽ͺӽ֮
-*             ڹϵ˫׽ǺӽСڵǰѡ
-*             󣨻Сļ¼
+* 㷨	  [0, length - 1] һȫ 4 ˳洢ṹ
+*             󶥶ѺΰѶѶǰļ¼
+*             һ¼ٰµΪѡ
+*             4 ѵĸ߶Ƕѵһ룬ɾѶʱ Floyd Եɸѡ
+*             ȽϴԼΪȽϵһ롣ѵʵּ Heap.h
 * ʱ临Ӷ O(nlgn)
 * ռ临Ӷ O(1)
 * ȶ	 
@@ -90,48 +114,172 @@ void selection_sort(int* array, int length);
 void heap_sort(int* array, int length);
 
 
+/**
+* 㷨	 ѡ n Сļ¼ʡѡIntroselect
+* 㷨	 ͬѡȡ׼ֻ֣ nth ڵһࡣ
+*             ִ 2lgn ʱλλBFPRTѡȡ׼
+*             ֤Ҳʱ䡣
+*             ɺ array[nth] ΪӦڸλõļ¼ļ¼
+*             Ҳļ¼С
+* ʱ临Ӷ ƽO(n)O(n)
+* ռ临Ӷ O(lgn)
+* ȶ	 
+*/
+void select_nth(int* array, int length, int nth);
+
+
+/**
+* 㷨	 
+* 㷨	 С k ¼ŵ array ǰ k λã¼
+*             ˳ȷ select_nth ѡ k Сļ¼ɻֻ֣
+*             ǰ k ¼
+* ʱ临Ӷ O(n + klgk)
+* ռ临Ӷ O(lgn)
+* ȶ	 
+*/
+void partial_sort(int* array, int length, int k);
+
+
+/**
+* 㷨	 ʽ Top-Kнѣ
+* 㷨	 Ϊ k СѱĿǰΪֹ k ¼ѶΪ
+*             Сһ¼¼ڶѶʱֱӶ滻Ѷ³
+*             뼴ɣҪȫݣʺ
+* ʱ临Ӷ O(nlgk)Ͻӽ O(n + klgklg(n/k))
+* ռ临Ӷ O(k)
+*/
+struct Top_K {
+	int* heap;
+	int capacity;
+	int count;
+};
+
+// Ϊ k Ķѣʧʱ false
+bool top_k_init(Top_K* topk, int k);
+
+void top_k_destroy(Top_K* topk);
+
+void top_k_push(Top_K* topk, int value);
+
+// ѵǰ count<= k¼ӴСд result count
+int top_k_result(const Top_K* topk, int* result);
+
+//  array  k ¼ӴСд resultдĸ
+// ڴ治ʱ -1
+int top_k(const int* array, int length, int k, int* result);
+
+
 /**
 * 㷨	 鲢
 * 㷨	 ¼ֽΪ¼ [0, m][m + 1, length - 1]
-*             ֮ϲһʱ temp ϲɺ temp ƻС
-* ʱ临Ӷ O(lgn)
+*             ֮ϲһʱ temp СֻʹһΪ n 
+*             飬ÿ˹鲢ԭ븨֮佻У븴ƻ
+*             ȽСֱӲ
+* ʱ临Ӷ O(nlgn)
 * ռ临Ӷ O(n)
 * ȶ	 
+* 		 temp ΪṩĳȲС length ĸ飬
+*             Ϊ NULL ʱڲ
+* ֵ	 ʧʱ falseʱ array ֲ
 */
 
 // ÷ηϽж·鲢
 //
-void merge_sort(int* array, int length);
+bool merge_sort(int* array, int length, int* temp = NULL);
 
 // ÷η½ж·鲢
 //
-void merge_sort_dc(int* array, int length);
+bool merge_sort_dc(int* array, int length, int* temp = NULL);
+
 
 /**
-* 㷨	 
-* 㷨	 
-* ʱ临Ӷ O(n)
-* ռ临Ӷ O(n + m)
+* 㷨	 Ȼ鲢Timsort
+* 㷨	 еΣҳλϸݼΣתΪ
+*              minRun32 ~ 64Ķ۰ӳ
+*             ջջжγ B > AC > B + A Ĳʽʱ鲢ڵ
+*             Σʹÿι鲢೤鲢ʱĳһʤΣת
+*             ɱģʽgallopingָҳԳƵļ¼
+*             ʺϻݣ¼ٵİʱ׷ӵ־
+* ʱ临Ӷ O(nlgn)/O(n)r ʱ O(nlgr)
+* ռ临Ӷ O(n / 2)
 * ȶ	 
-* ʹ	 ¼ΪСڵ k 
+* 		 temp ΪṩĳȲС length / 2 ĸ飬
+*             Ϊ NULL ʱڲ
+* ֵ	 ʧʱ falseʱ array ֲ
 */
-void counting_sort(int* array, int length, int k);
+bool tim_sort(int* array, int length, int* temp = NULL);
 
 
 /**
-* 㷨	 /Ͱ
-* 㷨	 Ϊ N лֳ M 䣨ͰȻ
-*              ĳӳ亯еĹؼ k ӳ䵽 i ͰУͰ
-*              B ± i ôùؼ k Ϊ B[i] еԪأÿͰ B[i]
-*              һСΪN/MУŶÿͰ B[i] еԪؽ
-*              Ƚ򣨿ʹÿ򣩣Ȼö B[0]....B[M] е
-*              ȫݼһС
-* ʱ临Ӷ O(n)
-* ռ临Ӷ O(n + m)
+* 㷨	 鲢ԭȶ鲢
+* 㷨	 ϵĶ·鲢ÿι鲢ֻʹ O(sqrt(n)) СĻ
+*             ηֳɳ sqrt(n) Ŀ飬鰴׼¼ź˳A ǰ
+*             ҰÿǰδĲ־ֲ鲢ÿι鲢 O(n)
+*             ŵ½϶һʱֱӹ鲢̫Сʱ
+*             תһι鲢ֳСĹ鲢
+* ʱ临Ӷ O(nlgn)Ϊʱ O(nlgn) ~ O(nlg^2n)
+* ռ临Ӷ buffer ĳȣ 1024 ʱʹջ 4KB Ļ
 * ȶ	 
+* 		 buffer ΪṩĹһż¼һſţ
+*             bufferLength С 2 * sqrt(length) + 2 ʱÿι鲢 O(n)
 */
+void block_merge_sort(int* array, int length, int* buffer = NULL, int bufferLength = 0);
+
+// ȶʹõĸڴ
+enum Stable_Sort_Memory {
+	STABLE_SORT_MEMORY_LINEAR,	// O(n)merge_sort_dcʧʱ˵
+	STABLE_SORT_MEMORY_SQRT,	// O(sqrt(n))鲢
+	STABLE_SORT_MEMORY_NONE		// ڴ棺鲢ֻջϵĻ
+};
 
-// ֻ
+/**
+* 㷨	 ȶ
+* 㷨	 ڴԤ memory ѡ鲢鲢򣬲ڴ治ʧ
+* ȶ	 
+*/
+void stable_sort(int* array, int length, Stable_Sort_Memory memory = STABLE_SORT_MEMORY_LINEAR);
+
+// ȶԤ memory ·ֽջϵĻ
+size_t stable_sort_memory(int length, Stable_Sort_Memory memory);
+
+/**
+* 㷨	 
+* 㷨	 Сֵ min ֵ maxAVX2 ֵ [min, max]
+*             ÿֵٰдֵСʱ 4 ֱͼ
+*             ͬļ¼ͬһɵͣ١
+*             ֵ󡢼ڴԤ㣨ڼ¼Ҵ 16Kʱ
+*             radix_sort
+* ʱ临Ӷ O(n + m)m ΪֵС
+* ռ临Ӷ O(m)
+* ȶ	 ǣint ȵļ¼޷֣
+* ֵ	 ڴ治ʱ falseʱ array ֲ
+*/
+bool counting_sort_auto(int* array, int length);
+
+// ԭĽӿڣk Ϊݱʹãκ int 
+void counting_sort(int* array, int length, int k);
+
+
+/**
+* 㷨	 /Ͱ
+* 㷨	 ȡ 16 * m 򣬵Ⱦȡ m - 1 ָԪأ
+*             ѹؼֵֻ m Ͱm <= 128
+*             1) ָࣺԪذųһȫÿ¼޷֧
+*                 lgm õͰţһֽڵУ
+*             2) 䣺ͰļʼλãѼ¼ᵽУÿͰ
+*                һΣ
+*             3) Ͱݹ򣬲 2048 ¼ʱ quick_sort
+*             ظķָԪʱÿָԪһͰͰ
+*             Ҫ˴ظ Zipf ֲĹؼҲܾȻ֡
+* ʱ临Ӷ O(nlgn)
+* ռ临Ӷ O(n)
+* ȶ	 
+* 		 temp ΪȲС length ĸ飬Ϊ NULL ʱԶ
+* ֵ	 ռʧʱ falseʱ array ֲ
+*/
+bool sample_sort(int* array, int length, int* temp = NULL);
+
+// /Ͱ sample_sort ʵ
 //
 void bucket_sort(int* array, int length);
 
@@ -140,14 +288,90 @@ void bucket_sort(int* array, int length);
 * 㷨	 
 * 㷨	 ǶͰĸĽƹ㣬ӵλλζԹؼֵ
 *              Kj(j = d - 1d - 20)Ͱ
+*               8 λΪһ256 Ͱ32 λؼ 4 ˣ64 λ 8 ˣ
+*              1) ֻһݾͳƳ˵Ͱ
+*              2) йؼĳһ϶ͬʱһˣ
+*              3) ȡǰ˳λ任зתλ
+*                 תλתλ¼䡣
+*              ˳-inf <  < -0.0 < +0.0 <  < +inf < NaN
+*              NaN ۷Ŷ󣬱˴˰λģʽС
 * ʱ临Ӷ O(n)
-* ռ临Ӷ O(n + m)
+* ռ临Ӷ O(n)
 * ȶ	 
-*
+* 		 temp ΪṩĳȲС length ĸ飬
+*              Ϊ NULL ʱڲ
+* ֵ	 ʧʱ falseʱ array ֲ
 */
+bool radix_sort(int* array, size_t length, int* temp = NULL);
 
-// ֻ
-//
-void radix_sort(int* array, int length);
+bool radix_sort_int64(long long* array, size_t length, long long* temp = NULL);
+
+bool radix_sort_uint64(unsigned long long* array, size_t length, unsigned long long* temp = NULL);
+
+bool radix_sort_float(float* array, size_t length, float* temp = NULL);
+
+bool radix_sort_double(double* array, size_t length, double* temp = NULL);
+
+/**
+* 㷨	 ԭ MSD American flag sort
+* 㷨	 Ӹλλÿ 8 λΪһͳƵǰͰ
+*              ûÿ¼ֱӽͰУҪ飩
+*              ȻÿͰݹ鴦һ¼ٵͰֱӲ
+*              ʺڴޡٷһݵĳϣ 1000  int
+*               radix_sort Լ 35%ֵڴֻݱradix_sort Ϊ
+* ʱ临Ӷ O(n)
+* ռ临Ӷ O(1)ÿݹ 256 ͰⲻҪռ
+* ȶ	 
+*/
+void american_flag_sort(int* array, int length);
+
+
+/**
+* 㷨	 ѡ㷨smart_sort
+* 㷨	 ȳݣѡʵ㷨
+*             1) ¼٣<= 16ֱӲ򣻼¼٣< 32768ʱ
+*                μǷ򲻶תֵǷ񲻴
+*                ¼򣩡ȣtim_sortͬ 5)
+*             2) ȡɶļ¼ͳ뱾ζһµڶԵı
+*                ȣȾͳԺظıȫ
+*                ͬһĵΣȻ鲢tim_sortO(n) ɣ
+*             3) Сֵֵֵ򲻴ڼ¼Ҽ
+*                Ԥ֮ڣ
+*             4) Ȳ 90%簴ʱ׷ӡٵ־tim_sort
+*             5) ¼϶ʱû򣬼¼ٻظܶʱ
+*                ʡquick_sort
+*             Ҫռ㷨ʧʱ quick_sort
+* ʱ临Ӷ ȡѡе㷨Ϊ O(1)ֵ򡢼ǷʱΪ O(n)
+* 		 profile Ϊ NULL ʱطѡ񣬿ڼ¼־
+*/
+enum Sort_Choice {
+	SORT_CHOICE_INSERTION,			// insert_sort
+	SORT_CHOICE_INTROSORT,			// quick_sort
+	SORT_CHOICE_NATURAL_MERGE,		// tim_sort
+	SORT_CHOICE_COUNTING,			// counting_sort_auto
+	SORT_CHOICE_RADIX,				// radix_sort
+	SORT_CHOICE_PRESORTED,			// ʱתֻڼ¼ʱѡ
+};
+
+struct Sort_Profile {
+	int length;
+	bool sampled;					// Ƿ¼ʱظıΪ 0
+	int runPairs;					// ڶ
+	double sortedness;				// ڶζһµڶԵıԼΪ 0.6
+	double inversionRatio;			// ȾԵıΪ 0Ϊ 1ԼΪ 0.5
+	double duplicateRatio;			// Ⱦǰһͬļ¼ı
+	bool rangeKnown;				// Ƿֵ
+	int minValue;
+	int maxValue;
+	Sort_Choice choice;
+};
+
+// ֻ
+void smart_sort_analyze(const int* array, int length, Sort_Profile* profile);
+
+void smart_sort(int* array, int length, Sort_Profile* profile = NULL);
+
+// ѡƣ "tim_sort"
+const char* sort_choice_name(Sort_Choice choice);
 
 #endif // __SORT_ALGORITHMS_H__
\ No newline at end of file
@@ -0,0 +1,451 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <memory.h>
+#include <assert.h>
+
+#include "StringSort.h"
+
+// ַò
+#define STRING_INSERT_CUTOFF	32
+
+// ؼֿÿλֵַֽΪʣ೤
+#define STRING_CACHE_CHARS		7
+
+// MSD Ͱ0 ͰΪѵĩβַַ c  c + 1 Ͱ
+#define STRING_RADIX_BUCKETS	257
+
+int compare_strings(const String_Key* a, const String_Key* b)
+{
+	size_t length = (a->length < b->length) ? a->length : b->length;
+	int result = (length > 0) ? memcmp(a->data, b->data, length) : 0;
+
+	if (result != 0) {
+		return result;
+	}
+
+	return (a->length < b->length) ? -1 : (a->length > b->length);
+}
+
+// ab ǰ depth ַͬ depth ʼǰ׺ĳ
+inline size_t string_lcp(const String_Key* a, const String_Key* b, size_t depth)
+{
+	const unsigned char* p = (const unsigned char*)a->data;
+	const unsigned char* q = (const unsigned char*)b->data;
+	size_t length = (a->length < b->length) ? a->length : b->length;
+
+	while (depth < length && p[depth] == q[depth]) {
+		++depth;
+	}
+
+	return depth;
+}
+
+// ͬ string_lcpȽϵ bound
+inline size_t string_lcp_bounded(const String_Key* a, const String_Key* b, size_t depth, size_t bound)
+{
+	const unsigned char* p = (const unsigned char*)a->data;
+	const unsigned char* q = (const unsigned char*)b->data;
+	size_t length = (a->length < b->length) ? a->length : b->length;
+
+	length = (length < bound) ? length : bound;
+	while (depth < length && p[depth] == q[depth]) {
+		++depth;
+	}
+
+	return depth;
+}
+
+// ab ǰ׺Ϊ lcp ʱa ǷС b
+inline bool string_less_at(const String_Key* a, const String_Key* b, size_t lcp)
+{
+	if (lcp == b->length) {
+		return false;
+	}
+
+	return lcp == a->length
+		|| (unsigned char)a->data[lcp] < (unsigned char)b->data[lcp];
+}
+
+
+//=========================================================
+//					ؼֿ
+//=========================================================
+
+//  depth ʼ 7 ַ򣬲Ĳ 0ʣ೤ȣΪ 8
+inline unsigned long long string_cache_word(const String_Key* key, size_t depth)
+{
+	const unsigned char* p = (const unsigned char*)key->data + depth;
+	size_t remaining = key->length - depth;
+	unsigned long long word = 0;
+	size_t k;
+
+	if (remaining >= STRING_CACHE_CHARS) {
+		word = ((unsigned long long)p[0] << 56) | ((unsigned long long)p[1] << 48)
+			| ((unsigned long long)p[2] << 40) | ((unsigned long long)p[3] << 32)
+			| ((unsigned long long)p[4] << 24) | ((unsigned long long)p[5] << 16)
+			| ((unsigned long long)p[6] << 8);
+		return word | ((remaining > STRING_CACHE_CHARS) ? 8 : STRING_CACHE_CHARS);
+	}
+
+	for (k = 0; k < remaining; ++k) {
+		word |= (unsigned long long)p[k] << (56 - 8 * k);
+	}
+
+	return word | remaining;
+}
+
+// ʣ೤ȴ 7ַͬҪȽϺַ
+inline bool string_cache_continues(unsigned long long word)
+{
+	return (word & 0xFF) > STRING_CACHE_CHARS;
+}
+
+inline void string_cache_load(const String_Key* strings, unsigned long long* cache,
+	size_t length, size_t depth)
+{
+	for (size_t i = 0; i < length; ++i) {
+		cache[i] = string_cache_word(&strings[i], depth);
+	}
+}
+
+inline void string_cache_swap(String_Key* strings, unsigned long long* cache, size_t a, size_t b)
+{
+	String_Key key = strings[a];
+	unsigned long long word = cache[a];
+
+	strings[a] = strings[b];
+	cache[a] = cache[b];
+	strings[b] = key;
+	cache[b] = word;
+}
+
+inline unsigned long long string_median3(unsigned long long a, unsigned long long b,
+	unsigned long long c)
+{
+	if (a < b) {
+		return (b < c) ? b : ((a < c) ? c : a);
+	}
+
+	return (a < c) ? a : ((b < c) ? c : b);
+}
+
+// ᣺ȡֵ¼϶ʱȡֵֵ
+unsigned long long string_cache_pivot(const unsigned long long* cache, size_t length)
+{
+	size_t mid = length / 2;
+	size_t last = length - 1;
+	size_t step;
+
+	if (length < 1024) {
+		return string_median3(cache[0], cache[mid], cache[last]);
+	}
+
+	step = length / 8;
+	return string_median3(
+		string_median3(cache[0], cache[step], cache[2 * step]),
+		string_median3(cache[mid - step], cache[mid], cache[mid + step]),
+		string_median3(cache[last - 2 * step], cache[last - step], cache[last]));
+}
+
+// ֲ򣬻ͬҶδĩβʱȽϺַ
+void string_cache_insert_sort(String_Key* strings, unsigned long long* cache,
+	size_t length, size_t depth)
+{
+	String_Key key;
+	unsigned long long word;
+	size_t i, j;
+
+	for (i = 1; i < length; ++i) {
+		key = strings[i];
+		word = cache[i];
+
+		for (j = i; j > 0; --j) {
+			if (word > cache[j - 1]) {
+				break;
+			}
+
+			if (word == cache[j - 1]) {
+				if (!string_cache_continues(word)) {
+					break;
+				}
+
+				size_t lcp = string_lcp(&key, &strings[j - 1], depth + STRING_CACHE_CHARS);
+				if (!string_less_at(&key, &strings[j - 1], lcp)) {
+					break;
+				}
+			}
+
+			strings[j] = strings[j - 1];
+			cache[j] = cache[j - 1];
+		}
+
+		strings[j] = key;
+		cache[j] = word;
+	}
+}
+
+// ؼֿһ
+struct String_Range {
+	size_t offset;
+	size_t length;
+	size_t depth;
+};
+
+// cache Ϊ strings  depth ʼĻ
+void multikey_quick_sort_impl(String_Key* strings, unsigned long long* cache,
+	size_t length, size_t depth)
+{
+	String_Range parts[3];
+	unsigned long long pivot;
+	size_t lt, gt, i;
+	int k, largest;
+
+	while (length > STRING_INSERT_CUTOFF) {
+		pivot = string_cache_pivot(cache, length);
+
+		// ·֣[0, lt) Сᣬ[lt, gt) ڣ[gt, length) 
+		lt = 0;
+		i = 0;
+		gt = length;
+		while (i < gt) {
+			if (cache[i] < pivot) {
+				string_cache_swap(strings, cache, lt++, i++);
+			}
+			else if (cache[i] > pivot) {
+				string_cache_swap(strings, cache, i, --gt);
+			}
+			else {
+				++i;
+			}
+		}
+
+		parts[0].offset = 0;
+		parts[0].length = lt;
+		parts[0].depth = depth;
+
+		// ڵĲѵĩβʱַͬ 7 ַ
+		parts[1].offset = lt;
+		parts[1].length = string_cache_continues(pivot) ? gt - lt : 0;
+		parts[1].depth = depth + STRING_CACHE_CHARS;
+		if (parts[1].length > 1) {
+			string_cache_load(strings + lt, cache + lt, gt - lt, parts[1].depth);
+		}
+
+		parts[2].offset = gt;
+		parts[2].length = length - gt;
+		parts[2].depth = depth;
+
+		// Сֵݹ鴦Ĳѭд
+		largest = 0;
+		for (k = 1; k < 3; ++k) {
+			if (parts[k].length > parts[largest].length) {
+				largest = k;
+			}
+		}
+
+		for (k = 0; k < 3; ++k) {
+			if (k != largest && parts[k].length > 1) {
+				multikey_quick_sort_impl(strings + parts[k].offset, cache + parts[k].offset,
+					parts[k].length, parts[k].depth);
+			}
+		}
+
+		strings += parts[largest].offset;
+		cache += parts[largest].offset;
+		length = parts[largest].length;
+		depth = parts[largest].depth;
+	}
+
+	string_cache_insert_sort(strings, cache, length, depth);
+}
+
+bool multikey_quick_sort_strings(String_Key* strings, size_t length)
+{
+	assert(strings || length == 0);
+
+	unsigned long long* cache;
+
+	if (length < 2) {
+		return true;
+	}
+
+	cache = (unsigned long long*)malloc(length * sizeof(unsigned long long));
+	if (!cache) {
+		return false;
+	}
+
+	string_cache_load(strings, cache, length, 0);
+	multikey_quick_sort_impl(strings, cache, length, 0);
+
+	free(cache);
+
+	return true;
+}
+
+
+//=========================================================
+//					MSD 
+//=========================================================
+
+//  LCP Ĳ򣺸ַǰ depth ַͬ
+// lcp[i] Ϊ strings[i - 1]  strings[i] ǰ׺ȡ
+//  x 뵽 strings[i - 1] ֮ǰʱ֪ h = lcp(x, strings[i - 1]) strings[i - 2]
+// Ƚϣlcp[i - 1] > h ʱ x ҲС strings[i - 2]ǰ׺Ϊ hlcp[i - 1] < h ʱ
+// x  strings[i - 2]ǰ׺Ϊ lcp[i - 1]ֻʱҪ h ʼȽַ
+void string_lcp_insert_sort(String_Key* strings, size_t length, size_t depth)
+{
+	size_t lcp[STRING_INSERT_CUTOFF + 1];
+	String_Key x;
+	size_t i, j, right, left, h;
+
+	assert(length <= STRING_INSERT_CUTOFF);
+
+	for (j = 1; j < length; ++j) {
+		x = strings[j];
+		right = string_lcp(&x, &strings[j - 1], depth);
+
+		if (!string_less_at(&x, &strings[j - 1], right)) {
+			lcp[j] = right;
+			continue;
+		}
+
+		// x < strings[i - 1]right ΪߵĹǰ׺
+		i = j;
+		left = 0;
+		for (;;) {
+			strings[i] = strings[i - 1];
+			if (i < j) {
+				lcp[i + 1] = lcp[i];
+			}
+			--i;
+
+			if (i == 0) {
+				break;
+			}
+
+			h = lcp[i];
+			if (h < right) {
+				left = h;
+				break;
+			}
+
+			if (h == right) {
+				h = string_lcp(&x, &strings[i - 1], right);
+				if (!string_less_at(&x, &strings[i - 1], h)) {
+					left = h;
+					break;
+				}
+				right = h;
+			}
+		}
+
+		strings[i] = x;
+		lcp[i + 1] = right;
+		if (i > 0) {
+			lcp[i] = left;
+		}
+	}
+}
+
+//  depth ַڵͰ
+inline unsigned int string_bucket(const String_Key* key, size_t depth)
+{
+	return (depth < key->length) ? (unsigned char)key->data[depth] + 1 : 0;
+}
+
+void radix_sort_strings_impl(String_Key* strings, String_Key* temp,
+	unsigned short* oracle, size_t length, size_t depth)
+{
+	size_t counts[STRING_RADIX_BUCKETS];
+	size_t ends[STRING_RADIX_BUCKETS];
+	size_t i, sum, start;
+	unsigned int c, largest;
+
+	while (length >= STRING_INSERT_CUTOFF) {
+		memset(counts, 0, sizeof(counts));
+
+		for (i = 0; i < length; ++i) {
+			c = string_bucket(&strings[i], depth);
+			oracle[i] = (unsigned short)c;
+			++counts[c];
+		}
+
+		// ͬһͰйǰ׺һǰ׺ĳȺֱ
+		// ÿַֻһȽϵĿǰĹǰ׺Ϊֹ
+		c = oracle[0];
+		if (counts[c] == length) {
+			if (c == 0) {
+				return;
+			}
+
+			sum = strings[0].length;
+			for (i = 1; i < length && sum > depth + 1; ++i) {
+				start = string_lcp_bounded(&strings[0], &strings[i], depth + 1, sum);
+				sum = (start < sum) ? start : sum;
+			}
+
+			depth = sum;
+			continue;
+		}
+
+		sum = 0;
+		largest = 0;
+		for (c = 0; c < STRING_RADIX_BUCKETS; ++c) {
+			ends[c] = sum;
+			sum += counts[c];
+			if (counts[c] > counts[largest]) {
+				largest = c;
+			}
+		}
+
+		for (i = 0; i < length; ++i) {
+			temp[ends[oracle[i]]++] = strings[i];
+		}
+		memcpy(strings, temp, length * sizeof(String_Key));
+
+		// 0 ͰźãͰһַСĵݹ鴦ѭд
+		for (c = 1; c < STRING_RADIX_BUCKETS; ++c) {
+			if (c != largest && counts[c] > 1) {
+				start = ends[c] - counts[c];
+				radix_sort_strings_impl(strings + start, temp, oracle, counts[c], depth + 1);
+			}
+		}
+
+		if (largest == 0) {
+			return;
+		}
+
+		strings += ends[largest] - counts[largest];
+		length = counts[largest];
+		++depth;
+	}
+
+	string_lcp_insert_sort(strings, length, depth);
+}
+
+bool radix_sort_strings(String_Key* strings, size_t length)
+{
+	assert(strings || length == 0);
+
+	String_Key* temp;
+	unsigned short* oracle;
+
+	if (length < 2) {
+		return true;
+	}
+
+	temp = (String_Key*)malloc(length * sizeof(String_Key));
+	oracle = (unsigned short*)malloc(length * sizeof(unsigned short));
+	if (!temp || !oracle) {
+		free(temp);
+		free(oracle);
+		return false;
+	}
+
+	radix_sort_strings_impl(strings, temp, oracle, length, 0);
+
+	free(temp);
+	free(oracle);
+
+	return true;
+}
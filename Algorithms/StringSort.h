@@ -0,0 +1,63 @@
+#ifndef __STRING_SORT_H__
+#define __STRING_SORT_H__
+
+#include <stddef.h>
+
+/**
+* ַ򣺹ؼΪ (ָ, )ֽڣ޷ţȽϣ̵ǰ׺
+* ǰ棬 memcmp ٱȽϳȵĽַͬпԺ '\0'
+*
+* ñȽַʱÿαȽ϶ҪͷȽϹǰ׺ URL
+* ָݵĹǰ׺ܳ㷨λַ
+* Ѿȷͬǰ׺ٱȽϣÿַֻͨһΡ
+*
+* ֻƶ String_Keyơ޸ַ
+*/
+struct String_Key {
+	const char* data;
+	size_t length;
+};
+
+inline String_Key string_key(const char* data, size_t length)
+{
+	String_Key key = {data, length};
+	return key;
+}
+
+// Ƚֵַĺ memcmp ͬ
+int compare_strings(const String_Key* a, const String_Key* b);
+
+/**
+* 㷨	 ؼֿ·
+* 㷨	 Ե d λõַ·֣СڡڡᣬС
+*             ԱȽϵ d ַڵĲָΪȽϵ d + 1 ַ
+*             ÿζ 8 ֽڻУ 7 ֽΪַ
+*             򣬲Ĳ 0ֽΪʣ೤ȣΪ 8ʾ滹
+*             ַһ 64 λȽ൱ڱȽ 7 ַѵĩβ
+*             ַҲ벹 0 ֻ֡еڲֵַҪ 7 ֽڣ
+*             ʱֻʻ飬ʷɢڴеַ
+*             ÿεݹ鴦С֣ĲѭдջΪ O(lgn)
+* ʱ临Ӷ O(nlgn + D)D Ϊַַָ
+* ռ临Ӷ O(n)飬ÿַ 8 ֽڣ
+* ȶ	 
+* ֵ	 ڴ治ʱ falseʱ strings ֲ
+*/
+bool multikey_quick_sort_strings(String_Key* strings, size_t length);
+
+/**
+* 㷨	 MSD ַ
+* 㷨	  d ַַ䵽 257 Ͱ0 ͰΪѵĩβַ
+*             ѾźãٷֱͰĵ d + 1 ַȰѸַ
+*              d ַ飬ͳʱٷַ
+*             ַͬһͰʱһǵĹǰ׺䡣
+*             ¼ 32 ʱô LCP Ĳ򣺼ַ
+*             ǰ׺ȣʱƳһַĹǰ׺
+*             ²ҪȽַҪȽʱҲֻȽϹǰ׺֮Ĳ֡
+* ʱ临Ӷ O(D + n) Ϊ 257ֻڴ 32 ¼Ͱϼƣ
+* ռ临Ӷ O(n) strings ȳĻԼÿַ 2 ֽڣ
+* ȶ	 
+* ֵ	 ڴ治ʱ falseʱ strings ֲ
+*/
+bool radix_sort_strings(String_Key* strings, size_t length);
+
+#endif // __STRING_SORT_H__
@@ -0,0 +1,449 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <memory.h>
+#include <assert.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+#include "TaskScheduler.h"
+
+//=========================================================
+//					̹߳
+//=========================================================
+
+struct Thread {
+#ifdef _WIN32
+	HANDLE handle;
+#else
+	pthread_t handle;
+#endif
+	Thread_Function func;
+	void* arg;
+};
+
+#ifdef _WIN32
+DWORD WINAPI thread_entry(LPVOID param)
+{
+	Thread* thread = (Thread*)param;
+	thread->func(thread->arg);
+	return 0;
+}
+#else
+void* thread_entry(void* param)
+{
+	Thread* thread = (Thread*)param;
+	thread->func(thread->arg);
+	return NULL;
+}
+#endif
+
+Thread* thread_create(Thread_Function func, void* arg)
+{
+	assert(func);
+
+	Thread* thread = (Thread*)malloc(sizeof(Thread));
+	if (!thread) {
+		return NULL;
+	}
+
+	thread->func = func;
+	thread->arg = arg;
+
+#ifdef _WIN32
+	thread->handle = CreateThread(NULL, 0, thread_entry, thread, 0, NULL);
+	if (!thread->handle) {
+		free(thread);
+		return NULL;
+	}
+#else
+	if (pthread_create(&thread->handle, NULL, thread_entry, thread) != 0) {
+		free(thread);
+		return NULL;
+	}
+#endif
+
+	return thread;
+}
+
+void thread_join(Thread* thread)
+{
+	assert(thread);
+
+#ifdef _WIN32
+	WaitForSingleObject(thread->handle, INFINITE);
+	CloseHandle(thread->handle);
+#else
+	pthread_join(thread->handle, NULL);
+#endif
+
+	free(thread);
+}
+
+void thread_yield()
+{
+#ifdef _WIN32
+	SwitchToThread();
+#else
+	sched_yield();
+#endif
+}
+
+int thread_hardware_concurrency()
+{
+#ifdef _WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return (int)info.dwNumberOfProcessors;
+#else
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return (count > 0) ? (int)count : 1;
+#endif
+}
+
+long atomic_add(volatile long* value, long delta)
+{
+#ifdef _WIN32
+	return InterlockedExchangeAdd(value, delta) + delta;
+#else
+	return __sync_add_and_fetch(value, delta);
+#endif
+}
+
+struct Mutex {
+#ifdef _WIN32
+	CRITICAL_SECTION cs;
+#else
+	pthread_mutex_t mutex;
+#endif
+};
+
+Mutex* mutex_create()
+{
+	Mutex* mutex = (Mutex*)malloc(sizeof(Mutex));
+	if (!mutex) {
+		return NULL;
+	}
+
+#ifdef _WIN32
+	InitializeCriticalSection(&mutex->cs);
+#else
+	pthread_mutex_init(&mutex->mutex, NULL);
+#endif
+
+	return mutex;
+}
+
+void mutex_destroy(Mutex* mutex)
+{
+	if (!mutex) {
+		return;
+	}
+
+#ifdef _WIN32
+	DeleteCriticalSection(&mutex->cs);
+#else
+	pthread_mutex_destroy(&mutex->mutex);
+#endif
+
+	free(mutex);
+}
+
+void mutex_lock(Mutex* mutex)
+{
+#ifdef _WIN32
+	EnterCriticalSection(&mutex->cs);
+#else
+	pthread_mutex_lock(&mutex->mutex);
+#endif
+}
+
+void mutex_unlock(Mutex* mutex)
+{
+#ifdef _WIN32
+	LeaveCriticalSection(&mutex->cs);
+#else
+	pthread_mutex_unlock(&mutex->mutex);
+#endif
+}
+
+
+//=========================================================
+//					ȡ
+//=========================================================
+
+// ˫˶У[top, bottom) Ϊִе
+//  bottom ѹ롢ȡ top ȡߡ
+// lock Ϊ NULL ʱвãѹʧܣֱִ߳С
+struct Task_Deque {
+	Mutex* lock;
+	Task* tasks;
+	size_t capacity;
+	size_t top;
+	size_t bottom;
+};
+
+struct Task_Scheduler {
+	Task_Worker* workers;
+	int threads;
+	volatile long pending;	// δִ
+};
+
+struct Task_Worker {
+	Task_Scheduler* scheduler;
+	Task_Deque deque;
+	int index;
+	unsigned int seed;		// ѡȡȡ
+};
+
+#define TASK_DEQUE_INIT_CAPACITY	64
+
+bool task_deque_push(Task_Deque* deque, const Task* task)
+{
+	bool result = true;
+
+	if (!deque->lock) {
+		return false;
+	}
+
+	mutex_lock(deque->lock);
+
+	if (deque->bottom == deque->capacity) {
+		if (deque->top > 0) {
+			// ǰбȡµĿλǰ
+			memmove(deque->tasks, deque->tasks + deque->top,
+				(deque->bottom - deque->top) * sizeof(Task));
+			deque->bottom -= deque->top;
+			deque->top = 0;
+		}
+		else {
+			size_t capacity = deque->capacity ? deque->capacity * 2 : TASK_DEQUE_INIT_CAPACITY;
+			Task* tasks = (Task*)realloc(deque->tasks, capacity * sizeof(Task));
+			if (tasks) {
+				deque->tasks = tasks;
+				deque->capacity = capacity;
+			}
+			else {
+				result = false;
+			}
+		}
+	}
+
+	if (result) {
+		deque->tasks[deque->bottom++] = *task;
+	}
+
+	mutex_unlock(deque->lock);
+
+	return result;
+}
+
+bool task_deque_pop(Task_Deque* deque, Task* task)
+{
+	bool result = false;
+
+	if (!deque->lock) {
+		return false;
+	}
+
+	mutex_lock(deque->lock);
+
+	if (deque->bottom > deque->top) {
+		*task = deque->tasks[--deque->bottom];
+		result = true;
+	}
+
+	mutex_unlock(deque->lock);
+
+	return result;
+}
+
+bool task_deque_steal(Task_Deque* deque, Task* task)
+{
+	bool result = false;
+
+	if (!deque->lock) {
+		return false;
+	}
+
+	mutex_lock(deque->lock);
+
+	if (deque->bottom > deque->top) {
+		*task = deque->tasks[deque->top++];
+		result = true;
+
+		if (deque->top == deque->bottom) {
+			deque->top = deque->bottom = 0;
+		}
+	}
+
+	mutex_unlock(deque->lock);
+
+	return result;
+}
+
+void task_join_init(Task_Join* join, long pending, const Task* continuation)
+{
+	assert(join && pending > 0 && continuation);
+
+	join->pending = pending;
+	join->continuation = *continuation;
+}
+
+void task_join_add(Task_Join* join, long count)
+{
+	assert(join && count > 0);
+
+	atomic_add(&join->pending, count);
+}
+
+void task_execute(Task_Worker* worker, const Task* task)
+{
+	Task_Join* join = task->join;
+
+	task->func(worker, task);
+
+	// ټټ֤ pending ǰ
+	if (join && atomic_add(&join->pending, -1) == 0) {
+		task_spawn(worker, &join->continuation);
+	}
+
+	atomic_add(&worker->scheduler->pending, -1);
+}
+
+void task_spawn(Task_Worker* worker, const Task* task)
+{
+	assert(worker && task && task->func);
+
+	atomic_add(&worker->scheduler->pending, 1);
+
+	// вû޷ʱֱڵǰִ߳
+	if (!task_deque_push(&worker->deque, task)) {
+		task_execute(worker, task);
+	}
+}
+
+int task_worker_index(const Task_Worker* worker)
+{
+	assert(worker);
+
+	return worker->index;
+}
+
+int task_worker_count(const Task_Worker* worker)
+{
+	assert(worker);
+
+	return worker->scheduler->threads;
+}
+
+// ̵߳Ķȡ
+bool task_steal(Task_Worker* worker, Task* task)
+{
+	Task_Scheduler* scheduler = worker->scheduler;
+	int threads = scheduler->threads;
+	int i, victim;
+
+	if (threads <= 1) {
+		return false;
+	}
+
+	worker->seed = worker->seed * 1103515245 + 12345;
+	victim = (int)((worker->seed >> 16) % threads);
+
+	for (i = 0; i < threads; ++i, victim = (victim + 1) % threads) {
+		if (victim != worker->index
+			&& task_deque_steal(&scheduler->workers[victim].deque, task)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void task_worker_loop(void* arg)
+{
+	Task_Worker* worker = (Task_Worker*)arg;
+	Task task;
+
+	while (worker->scheduler->pending > 0) {
+		if (task_deque_pop(&worker->deque, &task)
+			|| task_steal(worker, &task)) {
+			task_execute(worker, &task);
+		}
+		else {
+			thread_yield();
+		}
+	}
+}
+
+void task_scheduler_run(int threads, const Task* root)
+{
+	assert(root && root->func);
+
+	int i;
+	Task_Scheduler scheduler;
+	Task_Worker inlineWorker;
+	Thread** handles = NULL;
+
+	if (threads <= 0) {
+		threads = thread_hardware_concurrency();
+	}
+
+	scheduler.threads = threads;
+	scheduler.pending = 0;
+	scheduler.workers = (Task_Worker*)calloc(threads, sizeof(Task_Worker));
+	if (threads > 1) {
+		handles = (Thread**)calloc(threads, sizeof(Thread*));
+	}
+
+	// ڴ治ʱ˻Ϊڵִ߳
+	if (!scheduler.workers || (threads > 1 && !handles)) {
+		free(scheduler.workers);
+		free(handles);
+
+		threads = 1;
+		scheduler.threads = 1;
+		scheduler.workers = &inlineWorker;
+		memset(&inlineWorker, 0, sizeof(inlineWorker));
+		handles = NULL;
+	}
+
+	// ʧʱ lock Ϊ NULLֱ߳Լִ
+	for (i = 0; i < threads; ++i) {
+		scheduler.workers[i].scheduler = &scheduler;
+		scheduler.workers[i].index = i;
+		scheduler.workers[i].seed = i * 2654435761u + 1;
+		scheduler.workers[i].deque.lock = mutex_create();
+	}
+
+	task_spawn(&scheduler.workers[0], root);
+
+	// ̴߳ʧʱ̣߳ǵ̣߳ȫ
+	for (i = 1; i < threads; ++i) {
+		handles[i] = thread_create(task_worker_loop, &scheduler.workers[i]);
+	}
+
+	task_worker_loop(&scheduler.workers[0]);
+
+	for (i = 1; i < threads; ++i) {
+		if (handles[i]) {
+			thread_join(handles[i]);
+		}
+	}
+
+	for (i = 0; i < threads; ++i) {
+		mutex_destroy(scheduler.workers[i].deque.lock);
+		free(scheduler.workers[i].deque.tasks);
+	}
+
+	if (scheduler.workers != &inlineWorker) {
+		free(scheduler.workers);
+	}
+	free(handles);
+}
@@ -0,0 +1,93 @@
+#ifndef __TASK_SCHEDULER_H__
+#define __TASK_SCHEDULER_H__
+
+#include <stddef.h>
+
+//=========================================================
+//					̹߳
+//=========================================================
+
+typedef void (*Thread_Function)(void* arg);
+
+struct Thread;
+
+// ִ߳ func(arg)ʧʱ NULL
+Thread* thread_create(Thread_Function func, void* arg);
+
+// ȴ߳̽ͷ߳
+void thread_join(Thread* thread);
+
+// ó
+void thread_yield();
+
+// ߼ˣ
+int thread_hardware_concurrency();
+
+// ԭӼӣֵ֮
+long atomic_add(volatile long* value, long delta);
+
+struct Mutex;
+
+Mutex* mutex_create();
+
+void mutex_destroy(Mutex* mutex);
+
+void mutex_lock(Mutex* mutex);
+
+void mutex_unlock(Mutex* mutex);
+
+
+//=========================================================
+//					ȡ
+//=========================================================
+
+/**
+ * ÿ߳ӵһ˫˶У̴߳Ӷеײѹ롢Լ
+ * ȳڻУе߳ѡ̣߳ж
+ * ȡȽȳ㷨ͨҲģ
+ * 񣨰񣩶ִ֮ task_scheduler_run ŷء
+ */
+
+struct Task_Worker;
+struct Task_Join;
+struct Task;
+
+typedef void (*Task_Function)(Task_Worker* worker, const Task* task);
+
+// 񣺶 context ָݵ [begin, end) 
+struct Task {
+	Task_Function func;
+	void* context;
+	size_t begin;
+	size_t end;
+	int level;			// нͣʣĵݹ
+	Task_Join* join;	// ɺ֪ͨļΪ NULL
+};
+
+// ɼǼǵ pending ֮ continuation 
+// ȫɺĳ¡鲢źõ䣩
+struct Task_Join {
+	volatile long pending;
+	Task continuation;
+};
+
+void task_join_init(Task_Join* join, long pending, const Task* continuation);
+
+// ٵǼ count Ҫȴ
+// ԼĹתʱƳٶ join ֪ͨ
+void task_join_add(Task_Join* join, long count);
+
+// ɵǰִ̻߳߳
+void task_spawn(Task_Worker* worker, const Task* task);
+
+// ǰ̵߳ı [0, threads)
+int task_worker_index(const Task_Worker* worker);
+
+// ̵߳ĸ
+int task_worker_count(const Task_Worker* worker);
+
+//  threads ִ̣̣߳߳ root ȫ
+// threads <= 0 ʱʹȫ
+void task_scheduler_run(int threads, const Task* root);
+
+#endif // __TASK_SCHEDULER_H__
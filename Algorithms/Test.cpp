@@ -3,7 +3,26 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <assert.h>
+#include <memory.h>
+#include <algorithm>
+#include <limits>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
 #include "SortAlgorithms.h"
+#include "ParallelSort.h"
+#include "SimdSort.h"
+#include "ExternalSort.h"
+#include "KeyValueSort.h"
+#include "KWayMerge.h"
+#include "StringSort.h"
+#include "SetOperations.h"
+#include "Heap.h"
+#include "TaskScheduler.h"
 #include "SearchAlgorithms.h"
 #include "BinaryTree.h"
 #include "BTree.h"
@@ -41,6 +60,60 @@ struct SortFucntionInfo {
 	Sort_Function func;
 };
 
+// 鲢Ҫռ䣬ڴ治ʱ false
+//
+void merge_sort_test(int* array, int length)
+{
+	if (!merge_sort(array, length)) {
+		printf("Error: out of memory!\n");
+	}
+}
+
+void merge_sort_dc_test(int* array, int length)
+{
+	if (!merge_sort_dc(array, length)) {
+		printf("Error: out of memory!\n");
+	}
+}
+
+void block_merge_sort_test(int* array, int length)
+{
+	block_merge_sort(array, length);
+}
+
+void tim_sort_test(int* array, int length)
+{
+	if (!tim_sort(array, length)) {
+		printf("Error: out of memory!\n");
+	}
+}
+
+void radix_sort_test(int* array, int length)
+{
+	if (!radix_sort(array, length)) {
+		printf("Error: out of memory!\n");
+	}
+}
+
+void sample_sort_test(int* array, int length)
+{
+	if (!sample_sort(array, length)) {
+		printf("Error: out of memory!\n");
+	}
+}
+
+void smart_sort_test(int* array, int length)
+{
+	smart_sort(array, length);
+}
+
+void counting_sort_test(int* array, int length)
+{
+	if (!counting_sort_auto(array, length)) {
+		printf("Error: out of memory!\n");
+	}
+}
+
 SortFucntionInfo sort_function_list[] = {
 	{"ֱӲ",				insert_sort},
 	{"ϣ",					shell_sort},
@@ -49,10 +122,15 @@ SortFucntionInfo sort_function_list[] = {
 	{"",					quick_sort},
 	{"ֱѡ",				selection_sort},
 	{"",					heap_sort},
-	{"ϲ϶·鲢",	merge_sort},
-	{"ϲ·",		merge_sort_dc},
-	{"Ͱ/",				bucket_sort},
-	{"",					radix_sort},
+	{"ϲ϶·鲢",	merge_sort_test},
+	{"ϲ·",		merge_sort_dc_test},
+	{"Ȼ鲢Timsort",	tim_sort_test},
+	{"鲢ԭȶ",		block_merge_sort_test},
+	{"Ͱ/",		bucket_sort},
+	{"",					radix_sort_test},
+	{"ԭ MSD ",			american_flag_sort},
+	{"С˫",	small_sort},
+	{"ѡ㷨smart_sort",	smart_sort_test},
 	{"", NULL}
 };
 
@@ -98,6 +176,1633 @@ void test_sort()
 	print_array(array2, length, " data: ");
 }
 
+//==================================================================
+//					㷨
+//==================================================================
+
+// ݵķֲ
+enum Data_Distribution {
+	Data_Random = 0,	// 
+	Data_Sorted,		// 
+	Data_Reversed,		// 
+	Data_Organ_Pipe,	// 󽵣ܷ٣
+	Data_Nearly_Sorted,	// ʱ׷ӵ־򣬵 1% ļ¼ٵ
+	Data_Few_Unique,	// ظֻࣺܶ [-500, 500) е 1000 ֵͬ
+	Data_Distribution_Count,
+};
+
+const char* data_distribution_name[Data_Distribution_Count] = {
+	"random", "sorted", "reversed", "organ pipe", "nearly sorted", "few unique",
+};
+
+// rand() ĳЩƽֻ̨ 15 λȡ 15 λƴӳ 30 λķǸ
+int random_int()
+{
+	return ((rand() & 0x7fff) << 15) | (rand() & 0x7fff);
+}
+
+// ֲ dist  length 
+//
+void generate_data(int* array, int length, Data_Distribution dist)
+{
+	assert(array && length >= 0);
+
+	int i;
+
+	for (i = 0; i < length; ++i) {
+		switch (dist) {
+		case Data_Random:
+			array[i] = random_int();
+			break;
+
+		case Data_Sorted:
+			array[i] = i;
+			break;
+
+		case Data_Reversed:
+			array[i] = length - i;
+			break;
+
+		case Data_Organ_Pipe:
+			array[i] = (i < length / 2) ? i : length - i;
+			break;
+
+		case Data_Nearly_Sorted:
+			array[i] = (rand() % 100 == 0) ? i - random_int() % 1000 : i;
+			break;
+
+		case Data_Few_Unique:
+			array[i] = random_int() % 1000 - 500;
+			break;
+
+		default:
+			array[i] = 0;
+			break;
+		}
+	}
+}
+
+// ǽʱ䣨룩clock()  POSIX ͳƵǽռõ CPU ʱ䣬
+// ߳ʱѸ̵߳ʱۼ
+double wall_time_ms()
+{
+#ifdef _WIN32
+	LARGE_INTEGER frequency, counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	return counter.QuadPart * 1000.0 / frequency.QuadPart;
+#else
+	timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+#endif
+}
+
+bool is_sorted(const int* array, int length)
+{
+	for (int i = 1; i < length; ++i) {
+		if (array[i] < array[i - 1]) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//  func  data ĸ򣬷غʱ룩ʱ -1
+//
+double time_sort_function(Sort_Function func, int* array, const int* data, int length)
+{
+	memcpy(array, data, length * sizeof(int));
+
+	double start = wall_time_ms();
+	func(array, length);
+	double end = wall_time_ms();
+
+	if (!is_sorted(array, length)) {
+		return -1;
+	}
+
+	return end - start;
+}
+
+void quick_sort_hoare(int* array, int length)
+{
+	quick_sort_ex(array, length, QUICK_PARTITION_HOARE);
+}
+
+SortFucntionInfo sort_performance_list[] = {
+	{"quick_sort",		quick_sort},
+	{"quick_sort (Hoare)",	quick_sort_hoare},
+	{"heap_sort",		heap_sort},
+	{"merge_sort",		merge_sort_test},
+	{"merge_sort_dc",	merge_sort_dc_test},
+	{"tim_sort",		tim_sort_test},
+	{"block_merge_sort",	block_merge_sort_test},
+	{"sample_sort",		sample_sort_test},
+	{"radix_sort",		radix_sort_test},
+	{"counting_sort",	counting_sort_test},
+	{"american_flag_sort",	american_flag_sort},
+	{"smart_sort",		smart_sort_test},
+	{"", NULL}
+};
+
+// ڸֲַϲ㷨ĺʱ
+//
+void test_sort_performance()
+{
+	const int length = 1000000;
+	int i, j;
+
+	int* data = (int*)malloc(length * sizeof(int));
+	int* array = (int*)malloc(length * sizeof(int));
+	if (!data || !array) {
+		printf("Error: out of memory!\n");
+		free(data);
+		free(array);
+		return;
+	}
+
+	printf("\n=== ܣ%d ¼λ ms ===\n", length);
+	printf("%-24s", "");
+	for (j = 0; j < Data_Distribution_Count; ++j) {
+		printf("%14s", data_distribution_name[j]);
+	}
+	printf("\n");
+
+	for (i = 0; sort_performance_list[i].func != NULL; ++i) {
+		printf("%-24s", sort_performance_list[i].name);
+
+		for (j = 0; j < Data_Distribution_Count; ++j) {
+			srand(j);
+			generate_data(data, length, (Data_Distribution)j);
+
+			printf("%14.1f", time_sort_function(
+				sort_performance_list[i].func, array, data, length));
+		}
+
+		printf("\n");
+	}
+
+	free(data);
+	free(array);
+}
+
+// ظ repeat θƲ򣬷ÿƽʱ룬ѿ۳Ƶʱ䣩
+//  3 ȡС̵ֵĸš
+//
+double time_sort_repeated(Sort_Function func, int* array, const int* data, int length, int repeat)
+{
+	double start, copy, elapsed, best = -1;
+	int i, round;
+
+	for (round = 0; round < 3; ++round) {
+		start = wall_time_ms();
+		for (i = 0; i < repeat; ++i) {
+			memcpy(array, data, length * sizeof(int));
+		}
+		copy = wall_time_ms() - start;
+
+		start = wall_time_ms();
+		for (i = 0; i < repeat; ++i) {
+			memcpy(array, data, length * sizeof(int));
+			func(array, length);
+		}
+		elapsed = wall_time_ms() - start - copy;
+
+		if (!is_sorted(array, length)) {
+			return -1;
+		}
+
+		if (best < 0 || elapsed < best) {
+			best = elapsed;
+		}
+	}
+
+	return best / repeat;
+}
+
+SortFucntionInfo smart_sort_candidate_list[] = {
+	{"quick_sort",		quick_sort},
+	{"tim_sort",		tim_sort_test},
+	{"counting_sort",	counting_sort_test},
+	{"radix_sort",		radix_sort_test},
+	{"", NULL}
+};
+
+// smart_sort ĵһ㷨ıֵʱ
+#define SMART_SORT_RATIO_LIMIT	1.10
+
+// ڸֲַͳϱȽ smart_sort 뵥һ㷨һ
+// smart_sort Ľ std::sort ȽϣزԱĵһ㷨 10% ϵ
+// ĩ
+//
+void test_smart_sort()
+{
+	const int maxLength = 1000000;
+	const int lengths[] = {1000, 30000, 1000000};
+	int i, j, k, round, length, repeat, best;
+	int slowCount = 0, errorCount = 0;
+	double elapsed, bestTime, smartTime, ratio;
+	bool correct;
+	Sort_Profile profile;
+
+	int* data = (int*)malloc(maxLength * sizeof(int));
+	int* array = (int*)malloc(maxLength * sizeof(int));
+	int* expected = (int*)malloc(maxLength * sizeof(int));
+	if (!data || !array || !expected) {
+		printf("Error: out of memory!\n");
+		free(data);
+		free(array);
+		free(expected);
+		return;
+	}
+
+	printf("\n=== smart_sort ĵһ㷨λ ms ===\n");
+	printf("%10s%16s%16s%10s%16s%10s%8s%8s\n", "length", "distribution", "best", "time",
+		"smart_sort", "time", "ratio", "sorted");
+
+	for (k = 0; k < (int)(sizeof(lengths) / sizeof(lengths[0])); ++k) {
+		length = lengths[k];
+		repeat = 5 * maxLength / length;
+
+		for (j = 0; j < Data_Distribution_Count; ++j) {
+			srand(j);
+			generate_data(data, length, (Data_Distribution)j);
+
+			best = 0;
+			bestTime = -1;
+			for (i = 0; smart_sort_candidate_list[i].func != NULL; ++i) {
+				elapsed = time_sort_repeated(smart_sort_candidate_list[i].func, array, data, length, repeat);
+				if (bestTime < 0 || elapsed < bestTime) {
+					best = i;
+					bestTime = elapsed;
+				}
+			}
+
+			smartTime = time_sort_repeated(smart_sort_test, array, data, length, repeat);
+
+			// ʱ 10%~30%ʱ߽ز⼸֣ȡСֵ
+			for (round = 0; round < 3 && smartTime > bestTime * SMART_SORT_RATIO_LIMIT; ++round) {
+				elapsed = time_sort_repeated(smart_sort_candidate_list[best].func, array, data, length, repeat);
+				bestTime = (elapsed < bestTime) ? elapsed : bestTime;
+				elapsed = time_sort_repeated(smart_sort_test, array, data, length, repeat);
+				smartTime = (elapsed < smartTime) ? elapsed : smartTime;
+			}
+
+			smart_sort_analyze(data, length, &profile);
+
+			memcpy(array, data, length * sizeof(int));
+			smart_sort_test(array, length);
+			memcpy(expected, data, length * sizeof(int));
+			std::sort(expected, expected + length);
+			correct = (memcmp(array, expected, length * sizeof(int)) == 0);
+
+			ratio = smartTime / bestTime;
+			printf("%10d%16s%16s%10.3f%16s%10.3f%8.2f%8.2f%s%s\n", length, data_distribution_name[j],
+				smart_sort_candidate_list[best].name, bestTime,
+				sort_choice_name(profile.choice), smartTime, ratio, profile.sortedness,
+				ratio > SMART_SORT_RATIO_LIMIT ? "  (slow)" : "", correct ? "" : "  (error)");
+
+			if (ratio > SMART_SORT_RATIO_LIMIT) {
+				++slowCount;
+			}
+
+			if (!correct) {
+				++errorCount;
+			}
+		}
+	}
+
+	printf("ĵһ㷨 %.0f%% ϣ%d %d \n",
+		(SMART_SORT_RATIO_LIMIT - 1) * 100, slowCount, errorCount);
+
+	free(data);
+	free(array);
+	free(expected);
+}
+
+typedef void (*Merge_Function)(const int* a, size_t na, const int* b, size_t nb, int* out);
+
+// ظ repeat ι鲢3 ȡСֵÿ¼ƽʱ룩
+//
+double time_merge_repeated(Merge_Function func, const int* data, int length, int* out, int repeat)
+{
+	double start, elapsed, best = -1;
+	int i, round;
+
+	for (round = 0; round < 3; ++round) {
+		start = wall_time_ms();
+		for (i = 0; i < repeat; ++i) {
+			func(data, length / 2, data + length / 2, length - length / 2, out);
+		}
+		elapsed = wall_time_ms() - start;
+
+		if (!is_sorted(out, length)) {
+			return -1;
+		}
+
+		if (best < 0 || elapsed < best) {
+			best = elapsed;
+		}
+	}
+
+	return best * 1000000.0 / ((double)repeat * length);
+}
+
+// ·鲢Ϊ length / 2 УȽ simd_merge Ա
+//
+void test_merge_throughput()
+{
+	const int maxLength = 1 << 24;
+	const Data_Distribution distributions[] = {Data_Random, Data_Few_Unique};
+	int i, length, repeat;
+	double scalarTime, simdTime;
+
+	int* data = (int*)malloc(maxLength * sizeof(int));
+	int* out = (int*)malloc(maxLength * sizeof(int));
+	if (!data || !out) {
+		printf("Error: out of memory!\n");
+		free(data);
+		free(out);
+		return;
+	}
+
+	printf("\n=== ·鲢λ ns/¼AVX2 %s ===\n", cpu_has_avx2() ? "" : "");
+	printf("%10s%16s%10s%12s%8s\n", "length", "distribution", "scalar", "simd_merge", "ratio");
+
+	for (i = 0; i < (int)(sizeof(distributions) / sizeof(distributions[0])); ++i) {
+		for (length = 1 << 10; length <= maxLength; length <<= 2) {
+			generate_data(data, length, distributions[i]);
+			if (!radix_sort(data, length / 2) || !radix_sort(data + length / 2, length - length / 2)) {
+				printf("Error: out of memory!\n");
+				break;
+			}
+
+			repeat = (maxLength / length) > 1 ? maxLength / length : 1;
+			scalarTime = time_merge_repeated(scalar_merge, data, length, out, repeat);
+			simdTime = time_merge_repeated(simd_merge, data, length, out, repeat);
+
+			printf("%10d%16s%10.3f%12.3f%8.2f\n", length, data_distribution_name[distributions[i]],
+				scalarTime, simdTime, scalarTime / simdTime);
+		}
+	}
+
+	free(data);
+	free(out);
+}
+
+// 鲢ÿ˰ڵ simd_merge 鲢ֱֻʣһΣ buffer  out 
+//
+int* merge_runs_pairwise(int* buffer, int* out, size_t* lengths, int count)
+{
+	int* src = buffer;
+	int* dst = out;
+	int* swap;
+	size_t offset;
+	int i, n;
+
+	while (count > 1) {
+		offset = 0;
+		for (i = 0, n = 0; i < count; i += 2, ++n) {
+			if (i + 1 < count) {
+				simd_merge(src + offset, lengths[i], src + offset + lengths[i], lengths[i + 1], dst + offset);
+				lengths[n] = lengths[i] + lengths[i + 1];
+			}
+			else {
+				memcpy(dst + offset, src + offset, lengths[i] * sizeof(int));
+				lengths[n] = lengths[i];
+			}
+			offset += lengths[n];
+		}
+
+		count = n;
+		swap = src;
+		src = dst;
+		dst = swap;
+	}
+
+	return src;
+}
+
+// k ·鲢ܳȹ̶Ƚϰһ˹鲢鲢 lgk ˵ĺʱ
+//
+void test_kway_merge_performance()
+{
+	const int length = 1 << 22;
+	const int ways[] = {4, 16, 64, 256, 1024};
+	const int maxWays = 1024;
+	int i, j, k, round;
+	size_t runLength;
+	double start, kwayTime, pairwiseTime, elapsed;
+	const int* runs[maxWays];
+	size_t lengths[maxWays];
+	int* result;
+
+	int* data = (int*)malloc(length * sizeof(int));
+	int* buffer = (int*)malloc(length * sizeof(int));
+	int* out = (int*)malloc(length * sizeof(int));
+	if (!data || !buffer || !out) {
+		printf("Error: out of memory!\n");
+		free(data);
+		free(buffer);
+		free(out);
+		return;
+	}
+
+	printf("\n=== k ·鲢 %d ¼λ ms ===\n", length);
+	printf("%8s%12s%12s%8s\n", "k", "loser tree", "pairwise", "ratio");
+
+	for (i = 0; i < (int)(sizeof(ways) / sizeof(ways[0])); ++i) {
+		k = ways[i];
+		runLength = length / k;
+
+		generate_data(data, length, Data_Random);
+		for (j = 0; j < k; ++j) {
+			if (!radix_sort(data + j * runLength, (int)runLength)) {
+				printf("Error: out of memory!\n");
+				break;
+			}
+			runs[j] = data + j * runLength;
+		}
+
+		kwayTime = pairwiseTime = -1;
+		for (round = 0; round < 3; ++round) {
+			for (j = 0; j < k; ++j) {
+				lengths[j] = runLength;
+			}
+
+			start = wall_time_ms();
+			if (!kway_merge(runs, lengths, k, out)) {
+				printf("Error: out of memory!\n");
+			}
+			elapsed = wall_time_ms() - start;
+			if (!is_sorted(out, length)) {
+				printf("kway_merge \n");
+			}
+			kwayTime = (kwayTime < 0 || elapsed < kwayTime) ? elapsed : kwayTime;
+
+			memcpy(buffer, data, length * sizeof(int));
+			start = wall_time_ms();
+			result = merge_runs_pairwise(buffer, out, lengths, k);
+			elapsed = wall_time_ms() - start;
+			if (!is_sorted(result, length)) {
+				printf("鲢\n");
+			}
+			pairwiseTime = (pairwiseTime < 0 || elapsed < pairwiseTime) ? elapsed : pairwiseTime;
+		}
+
+		printf("%8d%12.2f%12.2f%8.2f\n", k, kwayTime, pairwiseTime, pairwiseTime / kwayTime);
+	}
+
+	free(data);
+	free(buffer);
+	free(out);
+}
+
+// ȶڸڴԤµĺʱڴ
+//
+void test_stable_sort_memory()
+{
+	const int maxLength = 10000000;
+	const Stable_Sort_Memory modes[] = {STABLE_SORT_MEMORY_LINEAR, STABLE_SORT_MEMORY_SQRT, STABLE_SORT_MEMORY_NONE};
+	const char* modeNames[] = {"O(n)", "O(sqrt(n))", "none"};
+	int i, j, length, round;
+	double start, elapsed, best, linearTime = 0;
+
+	int* data = (int*)malloc(maxLength * sizeof(int));
+	int* array = (int*)malloc(maxLength * sizeof(int));
+	if (!data || !array) {
+		printf("Error: out of memory!\n");
+		free(data);
+		free(array);
+		return;
+	}
+
+	printf("\n=== ȶڴԤ㣨ݣλ ms ===\n");
+	printf("%10s%12s%14s%10s%8s\n", "length", "memory", "allocated", "time", "ratio");
+
+	for (length = 100000; length <= maxLength; length *= 10) {
+		generate_data(data, length, Data_Random);
+
+		for (i = 0; i < (int)(sizeof(modes) / sizeof(modes[0])); ++i) {
+			best = -1;
+			for (round = 0; round < 3; ++round) {
+				memcpy(array, data, length * sizeof(int));
+				start = wall_time_ms();
+				stable_sort(array, length, modes[i]);
+				elapsed = wall_time_ms() - start;
+
+				if (best < 0 || elapsed < best) {
+					best = elapsed;
+				}
+			}
+
+			for (j = 1; j < length; ++j) {
+				if (array[j] < array[j - 1]) {
+					printf("%s \n", modeNames[i]);
+					break;
+				}
+			}
+
+			if (i == 0) {
+				linearTime = best;
+			}
+
+			printf("%10d%12s%12uKB%10.2f%8.2f\n", length, modeNames[i],
+				(unsigned int)(stable_sort_memory(length, modes[i]) >> 10), best, best / linearTime);
+		}
+	}
+
+	free(data);
+	free(array);
+}
+
+// ÿ¼ƫ k λõݣа k + 1 һ
+void generate_ksorted_data(int* array, int length, int k)
+{
+	int i, j, end, temp;
+
+	for (i = 0; i < length; ++i) {
+		array[i] = i;
+	}
+
+	for (i = 0; i < length; i += k + 1) {
+		end = (i + k + 1 < length) ? i + k + 1 : length;
+		for (j = end - 1; j > i; --j) {
+			int r = i + random_int() % (j - i + 1);
+			temp = array[j];
+			array[j] = array[r];
+			array[r] = temp;
+		}
+	}
+}
+
+// ӦΪ 0, 1, ..., length - 1
+bool is_identity(const int* array, int length)
+{
+	for (int i = 0; i < length; ++i) {
+		if (array[i] != i) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//  data λƽΪ k д outĸ
+// late Ϊ NULL ʱȡسٵļ¼ڴ治ʱ 0
+size_t run_ksorted_stream(const int* data, int length, size_t k, size_t batch, int* out, size_t* late)
+{
+	KSorted_Stream stream;
+	size_t n = 0, pos;
+
+	if (!ksorted_stream_init(&stream, k)) {
+		return 0;
+	}
+
+	for (pos = 0; pos < (size_t)length; pos += batch) {
+		n += ksorted_stream_push_all(&stream, data + pos,
+			(pos + batch < (size_t)length) ? batch : length - pos, out + n);
+	}
+
+	while (ksorted_stream_pull(&stream, out + n)) {
+		++n;
+	}
+
+	if (late) {
+		*late = stream.late;
+	}
+
+	ksorted_stream_destroy(&stream);
+
+	return n;
+}
+
+// k ݣȫռ quick_sort  ksorted_sortʽĺʱԱȡ
+// λƳ k ݼٵ¼Ĵksorted_sort ö򣬽Ȼ
+// ȫ¼ٵĸ
+void test_ksorted_sort()
+{
+	const int length = 10000000;
+	const int ks[] = {16, 256, 4096, 65536};
+	const size_t batch = 4096;	// ʽÿμļ¼
+	const int lateLength = 1000000;
+	const int lateK = 16;		// λƽ
+	const int lateShift = 256;	// ʵʵλ
+	double start, quickTime, ksortedTime, streamTime;
+	size_t n, late;
+	int i;
+
+	int* data = (int*)malloc(length * sizeof(int));
+	int* array = (int*)malloc(length * sizeof(int));
+	if (!data || !array) {
+		printf("Error: out of memory!\n");
+		free(data);
+		free(array);
+		return;
+	}
+
+	printf("\n=== k ݵ%d ¼λ ms ===\n", length);
+	printf("%8s%14s%14s%14s\n", "k", "quick_sort", "ksorted_sort", "stream/4096");
+
+	for (i = 0; i < (int)(sizeof(ks) / sizeof(ks[0])); ++i) {
+		generate_ksorted_data(data, length, ks[i]);
+
+		memcpy(array, data, length * sizeof(int));
+		start = wall_time_ms();
+		quick_sort(array, length);
+		quickTime = wall_time_ms() - start;
+
+		memcpy(array, data, length * sizeof(int));
+		start = wall_time_ms();
+		if (!ksorted_sort(array, length, ks[i])) {
+			printf("Error: out of memory!\n");
+			break;
+		}
+		ksortedTime = wall_time_ms() - start;
+
+		if (!is_identity(array, length)) {
+			printf("k = %d ksorted_sort \n", ks[i]);
+		}
+
+		// ģݰ鵽ÿõܹĲ
+		memset(array, 0, length * sizeof(int));
+		start = wall_time_ms();
+		n = run_ksorted_stream(data, length, ks[i], batch, array, &late);
+		streamTime = wall_time_ms() - start;
+
+		if (n != (size_t)length || late != 0 || !is_identity(array, length)) {
+			printf("k = %d ʽ\n", ks[i]);
+		}
+
+		printf("%8d%14.1f%14.1f%14.1f\n", ks[i], quickTime, ksortedTime, streamTime);
+	}
+
+	// ¼ƫ lateShift λãȴλƽ lateK 
+	generate_ksorted_data(data, lateLength, lateShift);
+
+	memcpy(array, data, lateLength * sizeof(int));
+	if (!ksorted_sort(array, lateLength, lateK) || !is_identity(array, lateLength)) {
+		printf("k = %dʵλ %dksorted_sort \n", lateK, lateShift);
+	}
+
+	// Ѿļ¼ӦΪȫ¼ٵĸ 0
+	n = run_ksorted_stream(data, lateLength, lateK, batch, array, &late);
+	if (n == (size_t)lateLength) {
+		std::sort(array, array + n);
+	}
+	if (n != (size_t)lateLength || late == 0 || !is_identity(array, lateLength)) {
+		printf("k = %dʵλ %dʽ\n", lateK, lateShift);
+	}
+	else {
+		printf("k = %dʵλ %dгٵļ¼ %u \n", lateK, lateShift, (unsigned int)late);
+	}
+
+	free(data);
+	free(array);
+}
+
+//  length ϸļ¼ȡֵ [0, 3 * range) 
+int generate_set(int* array, int length, int range)
+{
+	int i;
+
+	for (i = 0; i < length; ++i) {
+		array[i] = random_int() % (3 * range);
+	}
+
+	quick_sort(array, length);
+	return (int)sorted_unique(array, length);
+}
+
+// Ĳοʵ֣򵥵ȽϵĹ鲢ֻ a Сֻ b С߶е
+// ¼ֱ keepAkeepBkeepBoth Ƿ
+size_t set_merge_reference(const int* a, size_t na, const int* b, size_t nb, int* out,
+	bool keepA, bool keepB, bool keepBoth)
+{
+	size_t i = 0, j = 0, n = 0;
+
+	while (i < na || j < nb) {
+		if (j == nb || (i < na && a[i] < b[j])) {
+			if (keepA) {
+				out[n++] = a[i];
+			}
+			++i;
+		}
+		else if (i == na || b[j] < a[i]) {
+			if (keepB) {
+				out[n++] = b[j];
+			}
+			++j;
+		}
+		else {
+			if (keepBoth) {
+				out[n++] = a[i];
+			}
+			++i;
+			++j;
+		}
+	}
+
+	return n;
+}
+
+// ȽϼĽοʵֵĽÿ¼Ҫͬ
+bool check_set_result(const int* out, size_t count, const int* expected, size_t expectedCount)
+{
+	return count == expectedCount && memcmp(out, expected, count * sizeof(int)) == 0;
+}
+
+// 򼯺󽻵ĸַڲͬСµĺʱԼ󲢡ĺʱ
+// ÿַĽοʵȽ
+void test_set_operations()
+{
+	const int largeLength = 10000000;
+	const int ratios[] = {1, 10, 100, 1000, 10000};
+	const Set_Intersect_Kernel kernels[] = {SET_INTERSECT_SCALAR, SET_INTERSECT_SSE,
+		SET_INTERSECT_AVX2, SET_INTERSECT_GALLOP, SET_INTERSECT_AUTO};
+	const char* kernelNames[] = {"scalar", "sse", "avx2", "gallop", "auto"};
+	const int kernelCount = sizeof(kernels) / sizeof(kernels[0]);
+	double start, elapsed, times[sizeof(kernels) / sizeof(kernels[0])], unionTime, differenceTime;
+	size_t count, expectedCount;
+	char ratio[16];
+	int i, j, round, nb, na;
+
+	int* b = (int*)malloc(largeLength * sizeof(int));
+	int* a = (int*)malloc(largeLength * sizeof(int));
+	int* out = (int*)malloc(2 * largeLength * sizeof(int));
+	int* expected = (int*)malloc(2 * largeLength * sizeof(int));
+	if (!a || !b || !out || !expected) {
+		printf("Error: out of memory!\n");
+		free(a);
+		free(b);
+		free(out);
+		free(expected);
+		return;
+	}
+
+	// ϴļÿ 3 ȡ 1 
+	for (i = 0; i < largeLength; ++i) {
+		b[i] = 3 * i + random_int() % 3;
+	}
+	nb = largeLength;
+
+	printf("\n=== 򼯺㣨ϴļ %d ¼λ ms ===\n", largeLength);
+	printf("%8s%10s%10s%10s%10s%10s%10s%10s\n", "ratio", "scalar", "sse", "avx2", "gallop", "auto",
+		"union", "diff");
+
+	for (i = 0; i < (int)(sizeof(ratios) / sizeof(ratios[0])); ++i) {
+		na = generate_set(a, largeLength / ratios[i], largeLength);
+
+		expectedCount = set_merge_reference(a, na, b, nb, expected, false, false, true);
+		for (j = 0; j < kernelCount; ++j) {
+			times[j] = -1;
+			for (round = 0; round < 3; ++round) {
+				start = wall_time_ms();
+				count = set_intersect_ex(a, na, b, nb, out, kernels[j]);
+				elapsed = wall_time_ms() - start;
+				times[j] = (times[j] < 0 || elapsed < times[j]) ? elapsed : times[j];
+			}
+
+			if (!check_set_result(out, count, expected, expectedCount)) {
+				printf("󽻽%s\n", kernelNames[j]);
+			}
+		}
+
+		unionTime = -1;
+		for (round = 0; round < 3; ++round) {
+			start = wall_time_ms();
+			count = set_union(a, na, b, nb, out);
+			elapsed = wall_time_ms() - start;
+			unionTime = (unionTime < 0 || elapsed < unionTime) ? elapsed : unionTime;
+		}
+
+		expectedCount = set_merge_reference(a, na, b, nb, expected, true, true, true);
+		if (!check_set_result(out, count, expected, expectedCount)) {
+			printf("󲢽\n");
+		}
+
+		differenceTime = -1;
+		for (round = 0; round < 3; ++round) {
+			start = wall_time_ms();
+			count = set_difference(b, nb, a, na, out);
+			elapsed = wall_time_ms() - start;
+			differenceTime = (differenceTime < 0 || elapsed < differenceTime) ? elapsed : differenceTime;
+		}
+
+		expectedCount = set_merge_reference(b, nb, a, na, expected, true, false, false);
+		if (!check_set_result(out, count, expected, expectedCount)) {
+			printf("\n");
+		}
+
+		sprintf(ratio, "1:%d", ratios[i]);
+		printf("%8s%10.2f%10.2f%10.2f%10.2f%10.2f%10.2f%10.2f\n", ratio, times[0], times[1],
+			times[2], times[3], times[4], unionTime, differenceTime);
+	}
+
+	free(a);
+	free(b);
+	free(out);
+	free(expected);
+}
+
+// std::sort бȽϵĺΪԱ
+struct Columns_Less {
+	const int* const* keys;
+	int keyCount;
+
+	bool operator()(unsigned int a, unsigned int b) const
+	{
+		for (int k = 0; k < keyCount; ++k) {
+			if (keys[k][a] != keys[k][b]) {
+				return keys[k][a] < keys[k][b];
+			}
+		}
+
+		return a < b;
+	}
+};
+
+// дŵļ¼ORDER BY a, b, c±
+// std::sort бȽϵĶԱȣԼ columns_sort ĺʱ
+void test_columns_sort()
+{
+	const int length = 10000000;
+	const int columnCount = 5;	// abc Ϊؼ֣и
+	const int keyCount = 3;
+	const int keys[] = {0, 1, 2};
+	int* columns[columnCount];
+	int* sorted[columnCount];
+	unsigned int* index = (unsigned int*)malloc(length * sizeof(unsigned int));
+	unsigned int* expected = (unsigned int*)malloc(length * sizeof(unsigned int));
+	double start, argsortTime = 0, stdTime, gatherTime, sortTime;
+	Columns_Less less;
+	bool ok = (index && expected);
+	int i, c;
+
+	for (c = 0; c < columnCount; ++c) {
+		columns[c] = (int*)malloc(length * sizeof(int));
+		sorted[c] = (int*)malloc(length * sizeof(int));
+		ok = ok && columns[c] && sorted[c];
+	}
+
+	if (ok) {
+		// a  100 ֵͬb  10000 c 븺Ϊ
+		for (i = 0; i < length; ++i) {
+			columns[0][i] = random_int() % 100;
+			columns[1][i] = random_int() % 10000 - 5000;
+			columns[2][i] = random_int();
+			columns[3][i] = i;
+			columns[4][i] = random_int();
+		}
+
+		// дһУȱҳʱ
+		for (c = 0; c < columnCount; ++c) {
+			memset(sorted[c], 0, length * sizeof(int));
+		}
+
+		start = wall_time_ms();
+		ok = columns_argsort(columns, keyCount, NULL, length, index);
+		argsortTime = wall_time_ms() - start;
+	}
+
+	if (!ok) {
+		printf("Error: out of memory!\n");
+	}
+	else {
+		less.keys = columns;
+		less.keyCount = keyCount;
+		for (i = 0; i < length; ++i) {
+			expected[i] = i;
+		}
+
+		start = wall_time_ms();
+		std::sort(expected, expected + length, less);
+		stdTime = wall_time_ms() - start;
+
+		if (memcmp(index, expected, length * sizeof(unsigned int)) != 0) {
+			printf("columns_argsort \n");
+		}
+
+		start = wall_time_ms();
+		columns_gather(columns, columnCount, index, length, sorted);
+		gatherTime = wall_time_ms() - start;
+
+		start = wall_time_ms();
+		columns_sort(columns, columnCount, keys, keyCount, NULL, length, sorted);
+		sortTime = wall_time_ms() - start;
+
+		for (c = 0; c < columnCount; ++c) {
+			for (i = 0; i < length; ++i) {
+				if (sorted[c][i] != columns[c][index[i]]) {
+					printf("columns_sort \n");
+					break;
+				}
+			}
+		}
+
+		printf("\n=== %d У%d ؼ֣%d Уλ ms ===\n", length, keyCount, columnCount);
+		printf("columns_argsort%.1fstd::sort бȽϣ%.1f\n", argsortTime, stdTime);
+		printf("columns_gather%d У%.1fcolumns_sort%.1f\n", columnCount, gatherTime, sortTime);
+	}
+
+	free(index);
+	free(expected);
+	for (c = 0; c < columnCount; ++c) {
+		free(columns[c]);
+		free(sorted[c]);
+	}
+}
+
+// Բ㷨߳ļٱ
+//
+typedef void (*Parallel_Sort_Function)(int* array, size_t length, int threads);
+
+struct ParallelSortFunctionInfo {
+	char * name;
+	Parallel_Sort_Function func;
+};
+
+void parallel_merge_sort_test(int* array, size_t length, int threads)
+{
+	if (!parallel_merge_sort(array, length, threads)) {
+		printf("Error: out of memory!\n");
+	}
+}
+
+void parallel_radix_sort_test(int* array, size_t length, int threads)
+{
+	if (!parallel_radix_sort(array, length, threads)) {
+		printf("Error: out of memory!\n");
+	}
+}
+
+void parallel_sample_sort_test(int* array, size_t length, int threads)
+{
+	if (!parallel_sample_sort(array, length, threads)) {
+		printf("Error: out of memory!\n");
+	}
+}
+
+void parallel_counting_sort_test(int* array, size_t length, int threads)
+{
+	if (!parallel_counting_sort(array, length, threads)) {
+		printf("Error: out of memory!\n");
+	}
+}
+
+ParallelSortFunctionInfo parallel_sort_performance_list[] = {
+	{"parallel_quick_sort",		parallel_quick_sort},
+	{"parallel_merge_sort",		parallel_merge_sort_test},
+	{"parallel_radix_sort",		parallel_radix_sort_test},
+	{"parallel_counting_sort",	parallel_counting_sort_test},
+	{"parallel_sample_sort",	parallel_sample_sort_test},
+	{"", NULL}
+};
+
+void test_parallel_sort_performance()
+{
+	const int length = 10000000;
+	int maxThreads = thread_hardware_concurrency();
+	int i, threads;
+	double start, serial, elapsed;
+
+	int* data = (int*)malloc(length * sizeof(int));
+	int* array = (int*)malloc(length * sizeof(int));
+	if (!data || !array) {
+		printf("Error: out of memory!\n");
+		free(data);
+		free(array);
+		return;
+	}
+
+	srand(0);
+	generate_data(data, length, Data_Random);
+
+	printf("\n=== ٱȣ%d ¼%d  ===\n", length, maxThreads);
+
+	serial = time_sort_function(quick_sort, array, data, length);
+	printf("%-24s%8s%12.1f ms\n", "quick_sort", "1", serial);
+
+	for (i = 0; parallel_sort_performance_list[i].func != NULL; ++i) {
+		for (threads = 1; ; threads *= 2) {
+			if (threads > maxThreads) {
+				threads = maxThreads;
+			}
+
+			memcpy(array, data, length * sizeof(int));
+
+			start = wall_time_ms();
+			parallel_sort_performance_list[i].func(array, length, threads);
+			elapsed = wall_time_ms() - start;
+
+			printf("%-24s%8d%12.1f ms  x%.2f%s\n",
+				parallel_sort_performance_list[i].name, threads, elapsed,
+				serial / elapsed, is_sorted(array, length) ? "" : "  (error)");
+
+			if (threads >= maxThreads) {
+				break;
+			}
+		}
+	}
+
+	free(data);
+	free(array);
+}
+
+// Top-K ĺʱ k ı仯Ա
+//
+void test_top_k_performance()
+{
+	const int length = 10000000;
+	const int maxK = 1000000;
+	int k;
+	double start, topK, partial, full, heap;
+
+	int* data = (int*)malloc(length * sizeof(int));
+	int* array = (int*)malloc(length * sizeof(int));
+	int* result = (int*)malloc(maxK * sizeof(int));
+	if (!data || !array || !result) {
+		printf("Error: out of memory!\n");
+		free(data);
+		free(array);
+		free(result);
+		return;
+	}
+
+	srand(0);
+	generate_data(data, length, Data_Random);
+
+	full = time_sort_function(quick_sort, array, data, length);
+	heap = time_sort_function(heap_sort, array, data, length);
+
+	printf("\n=== Top-K%d ¼λ ms ===\n", length);
+	printf("quick_sort ȫ %.1fheap_sort ȫ %.1f\n", full, heap);
+	printf("%10s%12s%14s\n", "k", "top_k", "partial_sort");
+
+	for (k = 10; k <= maxK; k *= 10) {
+		start = wall_time_ms();
+		top_k(data, length, k, result);
+		topK = wall_time_ms() - start;
+
+		// partial_sort ıݣڸϽУƲʱ
+		memcpy(array, data, length * sizeof(int));
+		start = wall_time_ms();
+		partial_sort(array, length, k);
+		partial = wall_time_ms() - start;
+
+		printf("%10d%12.1f%14.1f\n", k, topK, partial);
+	}
+
+	free(data);
+	free(array);
+	free(result);
+}
+
+// еļ¼ؼ֮⻹ֶ
+struct Test_Record {
+	int key;
+	int fields[7];
+};
+
+int compare_record_pointer(const void* a, const void* b)
+{
+	int x = (*(const Test_Record* const*)a)->key;
+	int y = (*(const Test_Record* const*)b)->key;
+	return (x < y) ? -1 : (x > y);
+}
+
+// ңݣֵ 0 Խ double
+void generate_doubles(double* array, size_t length)
+{
+	for (size_t i = 0; i < length; ++i) {
+		array[i] = (random_int() - (1 << 29)) * 1e-3 / (1 + random_int() % 1000);
+	}
+}
+
+// ʱλͬ򵽴
+void generate_timestamps(long long* array, size_t length)
+{
+	for (size_t i = 0; i < length; ++i) {
+		array[i] = 1700000000000000000LL + (long long)random_int() * 64 + random_int() % 64;
+	}
+}
+
+void generate_uint64(unsigned long long* array, size_t length)
+{
+	for (size_t i = 0; i < length; ++i) {
+		array[i] = ((unsigned long long)random_int() << 34) ^ ((unsigned long long)random_int() << 17) ^ random_int();
+	}
+}
+
+//  std::sort ͬһϵĺʱ룩ȡ 3 еСֵ
+template <typename T>
+void test_radix_key_type(const char* name, bool (*radix)(T*, size_t, T*),
+	void (*generate)(T*, size_t), size_t length)
+{
+	T* data = (T*)malloc(length * sizeof(T));
+	T* array = (T*)malloc(length * sizeof(T));
+	T* temp = (T*)malloc(length * sizeof(T));
+	double start, elapsed, radixTime = -1, sortTime = -1;
+	size_t i;
+	int round;
+
+	if (!data || !array || !temp) {
+		printf("Error: out of memory!\n");
+		free(data);
+		free(array);
+		free(temp);
+		return;
+	}
+
+	generate(data, length);
+
+	for (round = 0; round < 3; ++round) {
+		memcpy(array, data, length * sizeof(T));
+		start = wall_time_ms();
+		radix(array, length, temp);
+		elapsed = wall_time_ms() - start;
+		radixTime = (radixTime < 0 || elapsed < radixTime) ? elapsed : radixTime;
+
+		memcpy(temp, data, length * sizeof(T));
+		start = wall_time_ms();
+		std::sort(temp, temp + length);
+		elapsed = wall_time_ms() - start;
+		sortTime = (sortTime < 0 || elapsed < sortTime) ? elapsed : sortTime;
+	}
+
+	for (i = 0; i < length; ++i) {
+		if (array[i] != temp[i]) {
+			printf("%s \n", name);
+			break;
+		}
+	}
+
+	printf("%12s%12u%12.1f%12.1f%8.2f\n", name, (unsigned int)length, radixTime, sortTime, sortTime / radixTime);
+
+	free(data);
+	free(array);
+	free(temp);
+}
+
+// ˳-inf <  < -0.0 < +0.0 <  < +inf < NaN
+// Ѱ˳źõֵҺλȽϽ -0.0  +0.0
+//  NaN ķŲͬؼֻͬ
+template <typename T>
+bool check_radix_float_order(const char* name, bool (*radix)(T*, size_t, T*))
+{
+	typedef std::numeric_limits<T> Limits;
+
+	const T nan = Limits::quiet_NaN();
+	const T expected[] = {
+		-Limits::infinity(), -Limits::max(), (T)-1e10, (T)-1.5, (T)-1, -Limits::min(),
+		-Limits::denorm_min(), -(T)0, (T)0, Limits::denorm_min(), Limits::min(), (T)0.5,
+		(T)1, (T)3, Limits::max(), Limits::infinity(), nan, -nan,
+	};
+	const size_t length = sizeof(expected) / sizeof(expected[0]);
+	const size_t values = length - 2;	// ȥ NaN
+	T array[sizeof(expected) / sizeof(expected[0])];
+	size_t i;
+	bool correct;
+
+	// 7  18 أ i * 7 % 18 ȡΪһ̶
+	for (i = 0; i < length; ++i) {
+		array[i] = expected[i * 7 % length];
+	}
+
+	correct = radix(array, length, NULL)
+		&& memcmp(array, expected, values * sizeof(T)) == 0
+		&& array[values] != array[values] && array[values + 1] != array[values + 1];
+
+	if (!correct) {
+		printf("%s ֵ˳򲻶ԣ\n", name);
+	}
+
+	return correct;
+}
+
+//  doubleint64uint64 ؼȽstd::sortĶԱ
+//
+void test_radix_key_types()
+{
+	const size_t lengths[] = {1000000, 10000000, 30000000};
+
+	check_radix_float_order<float>("float", radix_sort_float);
+	check_radix_float_order<double>("double", radix_sort_double);
+
+	printf("\n===  std::sortλ ms ===\n");
+	printf("%12s%12s%12s%12s%8s\n", "key", "length", "radix", "std::sort", "ratio");
+
+	for (int i = 0; i < (int)(sizeof(lengths) / sizeof(lengths[0])); ++i) {
+		test_radix_key_type<double>("double", radix_sort_double, generate_doubles, lengths[i]);
+		test_radix_key_type<long long>("timestamp", radix_sort_int64, generate_timestamps, lengths[i]);
+		test_radix_key_type<unsigned long long>("uint64", radix_sort_uint64, generate_uint64, lengths[i]);
+	}
+}
+
+enum String_Data {
+	String_Urls,		// ͬЭ顢·ͬ
+	String_Random,		//  8 ~ 24 Сдĸ
+};
+
+//  length ַݴ *pool У free(*pool)
+bool generate_strings(String_Key* strings, size_t length, String_Data kind, char** pool)
+{
+	const char* sites[] = {"www.example.com", "api.example.com", "cdn.example.net", "blog.example.org"};
+	const size_t maxLength = 96;
+	char* text = (char*)malloc(length * maxLength);
+	char* p = text;
+	size_t i, k, n;
+
+	if (!text) {
+		return false;
+	}
+
+	for (i = 0; i < length; ++i) {
+		if (kind == String_Urls) {
+			n = sprintf(p, "https://%s/category/%d/item/%d?id=%d",
+				sites[random_int() % 4], random_int() % 100, random_int() % 100000, random_int() % 1000000);
+		}
+		else {
+			n = 8 + random_int() % 17;
+			for (k = 0; k < n; ++k) {
+				p[k] = (char)('a' + random_int() % 26);
+			}
+		}
+
+		strings[i] = string_key(p, n);
+		p += n;
+	}
+
+	*pool = text;
+	return true;
+}
+
+bool compare_string_less(const String_Key& a, const String_Key& b)
+{
+	return compare_strings(&a, &b) < 0;
+}
+
+bool std_sort_strings(String_Key* strings, size_t length)
+{
+	std::sort(strings, strings + length, compare_string_less);
+	return true;
+}
+
+// ַַÿ룩ȡ 3 еֵ
+void test_string_sort_throughput()
+{
+	const size_t lengths[] = {1000000, 10000000};
+	const String_Data kinds[] = {String_Urls, String_Random};
+	const char* kindNames[] = {"URL", "random"};
+	const char* sortNames[] = {"std::sort", "multikey quick", "MSD radix"};
+	bool (*sorts[])(String_Key*, size_t) = {std_sort_strings, multikey_quick_sort_strings, radix_sort_strings};
+
+	String_Key* data;
+	String_Key* array;
+	char* pool;
+	double start, elapsed, best;
+	size_t i, length;
+	int k, s, round;
+
+	printf("\n=== ַ򣨰ַÿ룩 ===\n");
+
+	for (i = 0; i < sizeof(lengths) / sizeof(lengths[0]); ++i) {
+		length = lengths[i];
+		data = (String_Key*)malloc(length * sizeof(String_Key));
+		array = (String_Key*)malloc(length * sizeof(String_Key));
+
+		for (k = 0; k < 2; ++k) {
+			if (!data || !array || !generate_strings(data, length, kinds[k], &pool)) {
+				printf("Error: out of memory!\n");
+				break;
+			}
+
+			for (s = 0; s < 3; ++s) {
+				best = -1;
+				for (round = 0; round < 3; ++round) {
+					memcpy(array, data, length * sizeof(String_Key));
+					start = wall_time_ms();
+					if (!sorts[s](array, length)) {
+						printf("Error: out of memory!\n");
+					}
+					elapsed = wall_time_ms() - start;
+					best = (best < 0 || elapsed < best) ? elapsed : best;
+				}
+
+				for (size_t j = 1; j < length; ++j) {
+					if (compare_strings(&array[j - 1], &array[j]) > 0) {
+						printf("%s \n", sortNames[s]);
+						break;
+					}
+				}
+
+				printf("%8s%10u%16s%10.1f ms%8.2f M/s\n", kindNames[k], (unsigned int)length,
+					sortNames[s], best, length / best / 1000.0);
+			}
+
+			free(pool);
+		}
+
+		free(data);
+		free(array);
+	}
+}
+
+// ֵֻ intñȽϺ¼ָĺʱԱ
+//
+// ֵĽvalues ǰΪ¼±꣨64 λصĸ 32 λٴһ±꣩
+//  keys values һ keys[i] == data[values[i]]
+// stable ʱؼȵļ¼±seen Ϊ length ֽڵĸռ
+template <typename Value>
+bool check_sorted_pairs(const int* data, const int* keys, const Value* values, int length,
+	bool stable, unsigned char* seen)
+{
+	unsigned int position, previous = 0;
+	int i;
+
+	memset(seen, 0, length);
+
+	for (i = 0; i < length; ++i) {
+		position = (unsigned int)values[i];
+		if (((unsigned long long)values[i] >> 32) != (sizeof(Value) > 4 ? position : 0)) {
+			return false;
+		}
+
+		if (position >= (unsigned int)length || seen[position] || data[position] != keys[i]) {
+			return false;
+		}
+		seen[position] = 1;
+
+		if (i > 0) {
+			if (keys[i] < keys[i - 1]) {
+				return false;
+			}
+
+			if (stable && keys[i] == keys[i - 1] && position < previous) {
+				return false;
+			}
+		}
+
+		previous = position;
+	}
+
+	return true;
+}
+
+void set_pair_positions(unsigned int* values, int length)
+{
+	for (int i = 0; i < length; ++i) {
+		values[i] = i;
+	}
+}
+
+void set_pair_positions(unsigned long long* values, int length)
+{
+	for (int i = 0; i < length; ++i) {
+		values[i] = ((unsigned long long)i << 32) | (unsigned int)i;
+	}
+}
+
+void test_key_value_sort_performance()
+{
+	const int length = 1000000;
+	const Data_Distribution distributions[] = {Data_Random, Data_Few_Unique};
+	int i, j, k;
+	double start;
+
+	int* data = (int*)malloc(length * sizeof(int));
+	int* keys = (int*)malloc(length * sizeof(int));
+	int* index = (int*)malloc(length * sizeof(int));
+	unsigned int* values32 = (unsigned int*)malloc(length * sizeof(unsigned int));
+	unsigned long long* values64 = (unsigned long long*)malloc(length * sizeof(unsigned long long));
+	unsigned char* seen = (unsigned char*)malloc(length);
+	Test_Record* records = (Test_Record*)malloc(length * sizeof(Test_Record));
+	Test_Record** pointers = (Test_Record**)malloc(length * sizeof(Test_Record*));
+	if (!data || !keys || !index || !values32 || !values64 || !seen || !records || !pointers) {
+		printf("Error: out of memory!\n");
+		free(data);
+		free(keys);
+		free(index);
+		free(values32);
+		free(values64);
+		free(seen);
+		free(records);
+		free(pointers);
+		return;
+	}
+
+	srand(0);
+
+	printf("\n=== ֵ%d ¼λ ms ===\n", length);
+	printf("%-12s%12s%12s%12s%12s\n", "", "int", "pairs32", "pairs64", "argsort");
+
+	for (j = 0; j < (int)(sizeof(distributions) / sizeof(distributions[0])); ++j) {
+		generate_data(data, length, distributions[j]);
+		printf("%s\n", data_distribution_name[distributions[j]]);
+
+		for (i = 0; i < 3; ++i) {
+			const char* names[] = {"radix", "merge", "quick"};
+			const bool stable = (i != 2);	// quick_sort_pairs ȶ
+			double elapsed[4];
+
+			memcpy(keys, data, length * sizeof(int));
+			start = wall_time_ms();
+			if (i == 0) {
+				radix_sort(keys, length);
+			}
+			else if (i == 1) {
+				merge_sort(keys, length);
+			}
+			else {
+				quick_sort(keys, length);
+			}
+			elapsed[0] = wall_time_ms() - start;
+
+			if (!is_sorted(keys, length)) {
+				printf("%s \n", names[i]);
+			}
+
+			memcpy(keys, data, length * sizeof(int));
+			set_pair_positions(values32, length);
+			start = wall_time_ms();
+			if (i == 0) {
+				radix_sort_pairs(keys, values32, length);
+			}
+			else if (i == 1) {
+				merge_sort_pairs(keys, values32, length);
+			}
+			else {
+				quick_sort_pairs(keys, values32, length);
+			}
+			elapsed[1] = wall_time_ms() - start;
+
+			if (!check_sorted_pairs(data, keys, values32, length, stable, seen)) {
+				printf("%s_sort_pairs32 λأ\n", names[i]);
+			}
+
+			memcpy(keys, data, length * sizeof(int));
+			set_pair_positions(values64, length);
+			start = wall_time_ms();
+			if (i == 0) {
+				radix_sort_pairs(keys, values64, length);
+			}
+			else if (i == 1) {
+				merge_sort_pairs(keys, values64, length);
+			}
+			else {
+				quick_sort_pairs(keys, values64, length);
+			}
+			elapsed[2] = wall_time_ms() - start;
+
+			if (!check_sorted_pairs(data, keys, values64, length, stable, seen)) {
+				printf("%s_sort_pairs64 λأ\n", names[i]);
+			}
+
+			start = wall_time_ms();
+			if (i == 0) {
+				radix_argsort(data, length, index);
+			}
+			else if (i == 1) {
+				merge_argsort(data, length, index);
+			}
+			else {
+				quick_argsort(data, length, index);
+			}
+			elapsed[3] = wall_time_ms() - start;
+
+			// ±һУĹؼ
+			for (k = 0; k < length; ++k) {
+				keys[k] = (index[k] >= 0 && index[k] < length) ? data[index[k]] : 0;
+			}
+			if (!check_sorted_pairs(data, keys, index, length, stable, seen)) {
+				printf("%s_argsort \n", names[i]);
+			}
+
+			printf("%-12s%12.1f%12.1f%12.1f%12.1f\n", names[i],
+				elapsed[0], elapsed[1], elapsed[2], elapsed[3]);
+		}
+
+		// գ¼У qsort ¼ָ룬ÿαȽ϶Ҫʼ¼
+		for (i = 0; i < length; ++i) {
+			records[i].key = data[i];
+			pointers[i] = &records[i];
+		}
+
+		start = wall_time_ms();
+		qsort(pointers, length, sizeof(Test_Record*), compare_record_pointer);
+		printf("%-12s%12.1f\n", "qsort (ptr)", wall_time_ms() - start);
+	}
+
+	free(data);
+	free(keys);
+	free(index);
+	free(values32);
+	free(values64);
+	free(seen);
+	free(records);
+	free(pointers);
+}
+
+// ȶУμ¼Ӧõ
+//
+void test_priority_queue()
+{
+	const int length = 11;
+	int data[length] = {65, 32, 49, 10, 18, 72, 27, 42, 18, 58, 91};
+	Priority_Queue queue;
+	int i;
+
+	printf("\n=== ȶУ4 Сѣ ===\n");
+
+	if (!priority_queue_init(&queue, 4)) {
+		printf("Error: out of memory!\n");
+		return;
+	}
+
+	print_array(data, length, " push: ");
+
+	for (i = 0; i < length; ++i) {
+		if (!priority_queue_push(&queue, data[i])) {
+			printf("Error: out of memory!\n");
+			priority_queue_destroy(&queue);
+			return;
+		}
+	}
+
+	printf("  pop: ");
+	while (!priority_queue_empty(&queue)) {
+		printf("%d ", priority_queue_pop(&queue));
+	}
+	printf("\n");
+
+	priority_queue_destroy(&queue);
+}
+
+// ⲿһļڲͬڴ򣬲ڴĽȽ
+//
+void test_external_sort()
+{
+	const int length = 16 * 1024 * 1024;
+	const char* inputPath = "external_sort_input.bin";
+	const char* outputPath = "external_sort_output.bin";
+	const size_t memoryLimits[] = {(size_t)256 << 20, (size_t)16 << 20, (size_t)4 << 20, (size_t)1 << 20};
+	int i;
+
+	int* data = (int*)malloc(length * sizeof(int));
+	int* result = (int*)malloc(length * sizeof(int));
+	if (!data || !result) {
+		printf("Error: out of memory!\n");
+		free(data);
+		free(result);
+		return;
+	}
+
+	srand(0);
+	generate_data(data, length, Data_Random);
+
+	FILE* file = fopen(inputPath, "wb");
+	if (!file || fwrite(data, sizeof(int), length, file) != (size_t)length) {
+		printf("Error: failed to write %s!\n", inputPath);
+		if (file) {
+			fclose(file);
+		}
+		free(data);
+		free(result);
+		return;
+	}
+	fclose(file);
+
+	quick_sort(data, length);
+
+	printf("\n=== ⲿ%d ¼%d MB ===\n", length, (int)(length * sizeof(int) >> 20));
+
+	for (i = 0; i < (int)(sizeof(memoryLimits) / sizeof(memoryLimits[0])); ++i) {
+		double start = wall_time_ms();
+		bool ok = external_sort(inputPath, outputPath, memoryLimits[i]);
+		double elapsed = wall_time_ms() - start;
+
+		if (ok) {
+			file = fopen(outputPath, "rb");
+			ok = file && fread(result, sizeof(int), length, file) == (size_t)length
+				&& memcmp(result, data, length * sizeof(int)) == 0;
+			if (file) {
+				fclose(file);
+			}
+		}
+
+		printf("memory %4d MB%12.1f ms%s\n", (int)(memoryLimits[i] >> 20), elapsed,
+			ok ? "" : "  (error)");
+	}
+
+	remove(inputPath);
+	remove(outputPath);
+
+	free(data);
+	free(result);
+}
+
 //==================================================================
 //					Ըֲ㷨
 //==================================================================
@@ -567,6 +2272,21 @@ typedef void (*Test_Function)();
 
 Test_Function test_function[] = {
 	test_sort,		// 㷨
+	//test_sort_performance,	// 㷨
+	//test_smart_sort,	//  smart_sort ѡ
+	//test_merge_throughput,	// Զ·鲢
+	//test_kway_merge_performance,	//  k ·鲢
+	//test_stable_sort_memory,	// ȶڴԤ
+	//test_radix_key_types,	//  64 λ븡ؼֵĻ
+	//test_string_sort_throughput,	// ַ
+	//test_ksorted_sort,	//  k ݵʽ
+	//test_set_operations,	// 򼯺ϵ󽻡󲢡
+	//test_columns_sort,	// ԰дŵļ¼Ķ
+	//test_parallel_sort_performance,	// Բ㷨ļٱ
+	//test_top_k_performance,	//  Top-K 
+	//test_key_value_sort_performance,	// Լֵ
+	//test_external_sort,	// ⲿ
+	//test_priority_queue,	// ȶ
 	//test_search,		// Բ㷨
 	//test_btree,		//  B- 
 	//test_redblacktree,	// Ժ